@@ -0,0 +1,28 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstddef>
+
+// Runs the function the given number of times and returns the average time in nanoseconds
+template<typename Function>
+double MeasureAverageNanoseconds(size_t iterations, Function&& function)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	for (size_t i = 0; i < iterations; ++i)
+		function();
+
+	auto end = std::chrono::steady_clock::now();
+	std::chrono::duration<double, std::nano> elapsed = end - start;
+	return elapsed.count() / static_cast<double>(iterations);
+}
+
+inline void PrintBenchmarkResult(const char* name, double averageNanoseconds)
+{
+	std::printf("%-48s %12.1f ns\n", name, averageNanoseconds);
+}
+
+void RunStreamingCopyBenchmarks();
+void RunBitmapDescriptorAllocatorBenchmarks();
+void RunHeapAllocationBenchmarks();
\ No newline at end of file
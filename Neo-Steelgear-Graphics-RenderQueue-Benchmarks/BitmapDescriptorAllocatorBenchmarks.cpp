@@ -0,0 +1,94 @@
+#include "Benchmarks.h"
+
+#include <d3d12.h>
+
+#include <BitmapDescriptorAllocator.h>
+
+namespace
+{
+	constexpr size_t NR_OF_DESCRIPTORS = 4096;
+	constexpr size_t ITERATIONS = 100;
+
+	// Null views keep the cost of view creation itself low, the allocator is what is measured
+	void AllocateAll(BitmapDescriptorAllocator& allocator)
+	{
+		for (size_t i = 0; i < NR_OF_DESCRIPTORS; ++i)
+			allocator.AllocateCBV();
+	}
+
+	void BenchmarkAllocateAndReset(ID3D12Device* device)
+	{
+		BitmapDescriptorAllocator allocator;
+		allocator.Initialize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, device,
+			NR_OF_DESCRIPTORS);
+		double allocateTime = 0.0;
+		double resetTime = 0.0;
+
+		for (size_t i = 0; i < ITERATIONS; ++i)
+		{
+			allocateTime += MeasureAverageNanoseconds(1, [&]()
+			{
+				AllocateAll(allocator);
+			});
+
+			resetTime += MeasureAverageNanoseconds(1, [&]()
+			{
+				allocator.Reset();
+			});
+		}
+
+		PrintBenchmarkResult("Allocate 4096 descriptors", allocateTime / ITERATIONS);
+		PrintBenchmarkResult("Reset 4096 used descriptors", resetTime / ITERATIONS);
+	}
+
+	void BenchmarkFragmentedReuse(ID3D12Device* device)
+	{
+		BitmapDescriptorAllocator allocator;
+		allocator.Initialize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, device,
+			NR_OF_DESCRIPTORS);
+		AllocateAll(allocator);
+
+		// Every other slot is freed, so each allocation has to search past a used one
+		double reuseTime = MeasureAverageNanoseconds(ITERATIONS, [&]()
+		{
+			for (size_t i = 0; i < NR_OF_DESCRIPTORS; i += 2)
+				allocator.DeallocateDescriptor(i);
+
+			for (size_t i = 0; i < NR_OF_DESCRIPTORS; i += 2)
+				allocator.AllocateCBV();
+		});
+
+		PrintBenchmarkResult("Free and reallocate 2048 interleaved slots", reuseTime);
+	}
+
+	void BenchmarkExpansion(ID3D12Device* device)
+	{
+		double expansionTime = MeasureAverageNanoseconds(ITERATIONS, [&]()
+		{
+			BitmapDescriptorAllocator allocator;
+			allocator.Initialize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, device, 1);
+			AllocateAll(allocator);
+			allocator.Reset();
+		});
+
+		PrintBenchmarkResult("Allocate 4096 descriptors growing from 1", expansionTime);
+	}
+}
+
+void RunBitmapDescriptorAllocatorBenchmarks()
+{
+	ID3D12Device* device = nullptr;
+	HRESULT hr = D3D12CreateDevice(nullptr, D3D_FEATURE_LEVEL_11_0,
+		IID_PPV_ARGS(&device));
+	if (FAILED(hr))
+	{
+		std::printf("Skipping bitmap descriptor allocator benchmarks, no device could be created\n");
+		return;
+	}
+
+	BenchmarkAllocateAndReset(device);
+	BenchmarkFragmentedReuse(device);
+	BenchmarkExpansion(device);
+
+	device->Release();
+}
\ No newline at end of file
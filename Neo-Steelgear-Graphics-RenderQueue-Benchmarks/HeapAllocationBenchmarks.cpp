@@ -0,0 +1,161 @@
+#include "Benchmarks.h"
+
+#include <random>
+#include <vector>
+
+#include <HeapHelper.h>
+#include <TLSFAllocator.h>
+#include <BuddyAllocator.h>
+
+namespace
+{
+	constexpr size_t HEAP_SIZE = 64 * 1024 * 1024;
+	constexpr size_t GRANULARITY = 256;
+	constexpr size_t NR_OF_OPERATIONS = 200000;
+	constexpr size_t MAX_LIVE_ALLOCATIONS = 2048;
+
+	// Gives HeapHelper the same allocate and free by handle interface as the offset allocators
+	class HeapHelperAllocator
+	{
+	private:
+		HeapHelper<int> helper;
+		AllocationStrategy strategy;
+
+	public:
+		HeapHelperAllocator(AllocationStrategy strategyToUse) : strategy(strategyToUse)
+		{
+			helper.Initialize(HEAP_SIZE);
+		}
+
+		size_t Allocate(size_t size)
+		{
+			return helper.AllocateChunk(size, strategy, GRANULARITY);
+		}
+
+		void Deallocate(size_t handle)
+		{
+			helper.DeallocateChunk(handle);
+		}
+	};
+
+	struct LiveAllocation
+	{
+		size_t handle = size_t(-1);
+		size_t size = 0;
+	};
+
+	template<typename Allocator>
+	size_t FindLargestAllocation(Allocator& allocator)
+	{
+		size_t low = 0;
+		size_t high = HEAP_SIZE / GRANULARITY;
+
+		while (low < high)
+		{
+			size_t middle = (low + high + 1) / 2;
+			size_t handle = allocator.Allocate(middle * GRANULARITY);
+
+			if (handle != size_t(-1))
+			{
+				allocator.Deallocate(handle);
+				low = middle;
+			}
+			else
+			{
+				high = middle - 1;
+			}
+		}
+
+		return low * GRANULARITY;
+	}
+
+	// Every allocator sees the same sequence of sizes and the same random choices of what to free
+	template<typename Allocator>
+	void BenchmarkAllocator(const char* name, Allocator& allocator,
+		const std::vector<size_t>& sizes)
+	{
+		std::mt19937 generator(1234);
+		std::vector<LiveAllocation> liveAllocations;
+		size_t liveSize = 0;
+		size_t nrOfFailedAllocations = 0;
+		size_t nextSize = 0;
+
+		double totalTime = MeasureAverageNanoseconds(1, [&]()
+		{
+			for (size_t i = 0; i < NR_OF_OPERATIONS; ++i)
+			{
+				bool allocate = liveAllocations.size() == 0 ||
+					(liveAllocations.size() < MAX_LIVE_ALLOCATIONS && generator() % 2 == 0);
+
+				if (allocate)
+				{
+					size_t size = sizes[nextSize++ % sizes.size()];
+					size_t handle = allocator.Allocate(size);
+
+					if (handle == size_t(-1))
+					{
+						++nrOfFailedAllocations;
+						continue;
+					}
+
+					liveAllocations.push_back({ handle, size });
+					liveSize += size;
+				}
+				else
+				{
+					size_t index = generator() % liveAllocations.size();
+					allocator.Deallocate(liveAllocations[index].handle);
+					liveSize -= liveAllocations[index].size;
+					liveAllocations[index] = liveAllocations.back();
+					liveAllocations.pop_back();
+				}
+			}
+		});
+
+		// Counts both rounding inside allocations and free space split into pieces too small to use
+		size_t freeSize = HEAP_SIZE - liveSize;
+		double fragmentation = freeSize == 0 ? 0.0 : 1.0 -
+			static_cast<double>(FindLargestAllocation(allocator)) / static_cast<double>(freeSize);
+
+		PrintBenchmarkResult(name, totalTime / static_cast<double>(NR_OF_OPERATIONS));
+		std::printf("    %zu failed allocations, fragmentation %.2f\n",
+			nrOfFailedAllocations, fragmentation);
+	}
+
+	void BenchmarkSizes(const char* workloadName, const std::vector<size_t>& sizes)
+	{
+		std::printf("%s\n", workloadName);
+
+		HeapHelperAllocator firstFit(AllocationStrategy::FIRST_FIT);
+		BenchmarkAllocator("  HeapHelper FIRST_FIT", firstFit, sizes);
+
+		HeapHelperAllocator bestFit(AllocationStrategy::BEST_FIT);
+		BenchmarkAllocator("  HeapHelper BEST_FIT", bestFit, sizes);
+
+		TLSFAllocator tlsf;
+		tlsf.Initialize(HEAP_SIZE, GRANULARITY);
+		BenchmarkAllocator("  TLSFAllocator", tlsf, sizes);
+
+		BuddyAllocator buddy;
+		buddy.Initialize(HEAP_SIZE, GRANULARITY);
+		BenchmarkAllocator("  BuddyAllocator", buddy, sizes);
+	}
+}
+
+void RunHeapAllocationBenchmarks()
+{
+	std::mt19937 generator(42);
+	std::vector<size_t> powerOfTwoSizes(NR_OF_OPERATIONS);
+	std::vector<size_t> arbitrarySizes(NR_OF_OPERATIONS);
+	std::uniform_int_distribution<size_t> exponentDistribution(8, 17);
+	std::uniform_int_distribution<size_t> unitDistribution(1, 256);
+
+	for (size_t i = 0; i < NR_OF_OPERATIONS; ++i)
+	{
+		powerOfTwoSizes[i] = size_t(1) << exponentDistribution(generator);
+		arbitrarySizes[i] = unitDistribution(generator) * GRANULARITY;
+	}
+
+	BenchmarkSizes("Power of two sizes, 256 B to 128 KiB", powerOfTwoSizes);
+	BenchmarkSizes("Multiples of 256 B, up to 64 KiB", arbitrarySizes);
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#include "Benchmarks.h"
+
+#include <cstring>
+#include <vector>
+
+#include <StreamingCopy.h>
+
+namespace
+{
+	void BenchmarkCopySize(size_t size)
+	{
+		// A destination larger than the caches keeps each copy writing cold memory, like an upload heap
+		const size_t destinationSize = size < 64 * 1024 * 1024 ? 64 * 1024 * 1024 : size;
+		const size_t iterations = (256 * 1024 * 1024) / size + 1;
+		std::vector<unsigned char> source(size, 0x5A);
+		std::vector<unsigned char> destination(destinationSize, 0);
+		size_t destinationOffset = 0;
+		volatile unsigned char sink = 0;
+
+		auto nextDestination = [&]()
+		{
+			unsigned char* toReturn = destination.data() + destinationOffset;
+			destinationOffset += size;
+			if (destinationOffset + size > destinationSize)
+				destinationOffset = 0;
+
+			return toReturn;
+		};
+
+		double memcpyTime = MeasureAverageNanoseconds(iterations, [&]()
+		{
+			std::memcpy(nextDestination(), source.data(), size);
+		});
+		sink = sink + destination[size / 2];
+
+		destinationOffset = 0;
+		double streamingTime = MeasureAverageNanoseconds(iterations, [&]()
+		{
+			StreamingCopy(nextDestination(), source.data(), size);
+		});
+		sink = sink + destination[size / 2];
+
+		char name[64];
+		std::snprintf(name, sizeof(name), "memcpy %zu bytes", size);
+		PrintBenchmarkResult(name, memcpyTime);
+		std::snprintf(name, sizeof(name), "StreamingCopy %zu bytes", size);
+		PrintBenchmarkResult(name, streamingTime);
+	}
+}
+
+// Copies into ordinary cached memory, write-combined upload heaps need a device and favour streaming further
+void RunStreamingCopyBenchmarks()
+{
+	const size_t sizes[] = { 64, 256, 4 * 1024, 64 * 1024, 1024 * 1024, 16 * 1024 * 1024 };
+
+	for (size_t size : sizes)
+		BenchmarkCopySize(size);
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+#include "Benchmarks.h"
+
+int main()
+{
+	RunStreamingCopyBenchmarks();
+	RunBitmapDescriptorAllocatorBenchmarks();
+	RunHeapAllocationBenchmarks();
+
+	return 0;
+}
\ No newline at end of file
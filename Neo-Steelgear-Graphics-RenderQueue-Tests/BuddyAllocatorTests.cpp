@@ -0,0 +1,125 @@
+#include "Tests.h"
+
+#include <map>
+#include <iterator>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <stdexcept>
+
+#include <BuddyAllocator.h>
+
+namespace
+{
+	constexpr size_t MINIMUM_BLOCK_SIZE = 256;
+	constexpr size_t TOTAL_SIZE = 1024 * 1024;
+
+	bool Throws(BuddyAllocator& allocator, size_t offset)
+	{
+		try
+		{
+			allocator.Deallocate(offset);
+		}
+		catch (const std::runtime_error&)
+		{
+			return true;
+		}
+
+		return false;
+	}
+
+	void TestBlocksAreNaturallyAlignedAndDisjoint()
+	{
+		const char* name = "BuddyBlocksAreNaturallyAlignedAndDisjoint";
+		BuddyAllocator allocator;
+		allocator.Initialize(TOTAL_SIZE, MINIMUM_BLOCK_SIZE);
+		std::mt19937 generator(7);
+		std::uniform_int_distribution<size_t> sizeDistribution(1, 32 * 1024);
+		std::map<size_t, size_t> allocations;
+		bool aligned = true;
+		bool disjoint = true;
+
+		for (size_t i = 0; i < 20000; ++i)
+		{
+			if (allocations.size() != 0 && generator() % 2 == 0)
+			{
+				auto toRemove = allocations.begin();
+				std::advance(toRemove, generator() % allocations.size());
+				allocator.Deallocate(toRemove->first);
+				allocations.erase(toRemove);
+				continue;
+			}
+
+			size_t size = BuddyAllocator::GetAllocationSize(sizeDistribution(generator),
+				MINIMUM_BLOCK_SIZE);
+			size_t offset = allocator.Allocate(size);
+			if (offset == size_t(-1))
+				continue;
+
+			aligned = aligned && offset % size == 0 && offset + size <= TOTAL_SIZE;
+			auto next = allocations.lower_bound(offset);
+			if (next != allocations.end() && next->first < offset + size)
+				disjoint = false;
+			if (next != allocations.begin() && std::prev(next)->first + std::prev(next)->second > offset)
+				disjoint = false;
+
+			allocations[offset] = size;
+		}
+
+		size_t allocatedSize = 0;
+		for (auto& allocation : allocations)
+			allocatedSize += allocation.second;
+
+		Check(aligned, name, "block is not aligned to its size or is outside of the range");
+		Check(disjoint, name, "blocks overlap");
+		Check(allocator.GetAllocatedSize() == allocatedSize, name, "allocated size is not tracked correctly");
+	}
+
+	void TestFreeingEverythingMergesBuddies()
+	{
+		const char* name = "BuddyFreeingEverythingMergesBuddies";
+		BuddyAllocator allocator;
+		allocator.Initialize(TOTAL_SIZE, MINIMUM_BLOCK_SIZE);
+		std::mt19937 generator(11);
+		std::vector<size_t> offsets;
+
+		for (size_t offset = allocator.Allocate(MINIMUM_BLOCK_SIZE << (generator() % 4));
+			offset != size_t(-1); offset = allocator.Allocate(MINIMUM_BLOCK_SIZE << (generator() % 4)))
+		{
+			offsets.push_back(offset);
+		}
+
+		std::shuffle(offsets.begin(), offsets.end(), generator);
+		for (size_t offset : offsets)
+			allocator.Deallocate(offset);
+
+		Check(allocator.GetAllocatedSize() == 0, name, "memory is still allocated");
+		Check(allocator.GetLargestFreeSize() == TOTAL_SIZE, name, "buddies were not merged");
+		Check(allocator.Allocate(TOTAL_SIZE) == 0, name, "the whole range could not be allocated");
+	}
+
+	void TestRoundingAndInvalidFree()
+	{
+		const char* name = "BuddyRoundingAndInvalidFree";
+		BuddyAllocator allocator;
+		allocator.Initialize(3 * 1024, MINIMUM_BLOCK_SIZE);
+
+		Check(allocator.GetTotalSize() == 2 * 1024, name, "range was not rounded down to a power of two");
+		Check(allocator.Allocate(MINIMUM_BLOCK_SIZE + 1) == 0, name, "first block did not start at the beginning");
+		Check(allocator.Allocate(1) == 2 * MINIMUM_BLOCK_SIZE, name, "small block was not placed after the rounded up block");
+		Check(allocator.Allocate(1024) == 1024, name, "block was not placed in the free buddy");
+		Check(allocator.Allocate(1) == 3 * MINIMUM_BLOCK_SIZE, name, "small block was not placed in the remaining space");
+		Check(allocator.Allocate(1) == size_t(-1), name, "allocation succeeded in a full range");
+
+		Check(Throws(allocator, MINIMUM_BLOCK_SIZE), name, "freeing the middle of a block did not throw");
+		allocator.Deallocate(2 * MINIMUM_BLOCK_SIZE);
+		Check(Throws(allocator, 2 * MINIMUM_BLOCK_SIZE), name, "freeing a block twice did not throw");
+	}
+}
+
+void RunBuddyAllocatorTests()
+{
+	TestBlocksAreNaturallyAlignedAndDisjoint();
+	TestFreeingEverythingMergesBuddies();
+	TestRoundingAndInvalidFree();
+}
\ No newline at end of file
@@ -0,0 +1,215 @@
+#include "Tests.h"
+
+#include <unordered_map>
+
+#include <d3d12.h>
+
+#include <ResidencyManager.h>
+#include <PooledHeapAllocatorGPU.h>
+#include <TLSFAllocator.h>
+
+namespace
+{
+	// Only reports its size, which is all the pooled allocator and the residency manager ask of a heap
+	class FakeHeap : public ID3D12Heap
+	{
+	private:
+		D3D12_HEAP_DESC desc = {};
+		ULONG nrOfReferences = 1;
+
+	public:
+		FakeHeap(size_t heapSize, D3D12_HEAP_TYPE heapType, D3D12_HEAP_FLAGS heapFlags)
+		{
+			desc.SizeInBytes = heapSize;
+			desc.Properties.Type = heapType;
+			desc.Flags = heapFlags;
+		}
+
+		virtual ~FakeHeap() = default;
+		FakeHeap(const FakeHeap& other) = delete;
+		FakeHeap& operator=(const FakeHeap& other) = delete;
+		FakeHeap(FakeHeap&& other) = delete;
+		FakeHeap& operator=(FakeHeap&& other) = delete;
+
+		HRESULT STDMETHODCALLTYPE QueryInterface(REFIID, void**) override
+		{
+			return E_NOINTERFACE;
+		}
+
+		ULONG STDMETHODCALLTYPE AddRef() override
+		{
+			return ++nrOfReferences;
+		}
+
+		ULONG STDMETHODCALLTYPE Release() override
+		{
+			ULONG toReturn = --nrOfReferences;
+
+			if (toReturn == 0)
+				delete this;
+
+			return toReturn;
+		}
+
+		HRESULT STDMETHODCALLTYPE GetPrivateData(REFGUID, UINT*, void*) override
+		{
+			return E_NOTIMPL;
+		}
+
+		HRESULT STDMETHODCALLTYPE SetPrivateData(REFGUID, UINT, const void*) override
+		{
+			return E_NOTIMPL;
+		}
+
+		HRESULT STDMETHODCALLTYPE SetPrivateDataInterface(REFGUID, const IUnknown*) override
+		{
+			return E_NOTIMPL;
+		}
+
+		HRESULT STDMETHODCALLTYPE SetName(LPCWSTR) override
+		{
+			return E_NOTIMPL;
+		}
+
+		HRESULT STDMETHODCALLTYPE GetDevice(REFIID, void**) override
+		{
+			return E_NOTIMPL;
+		}
+
+		D3D12_HEAP_DESC STDMETHODCALLTYPE GetDesc() override
+		{
+			return desc;
+		}
+	};
+
+	class TestResidencyBackend : public ResidencyBackend
+	{
+	private:
+		std::unordered_map<ID3D12Pageable*, bool> evicted;
+		size_t nrOfEvictedHeaps = 0;
+
+	public:
+		TestResidencyBackend() = default;
+		~TestResidencyBackend() = default;
+		TestResidencyBackend(const TestResidencyBackend& other) = delete;
+		TestResidencyBackend& operator=(const TestResidencyBackend& other) = delete;
+		TestResidencyBackend(TestResidencyBackend&& other) = default;
+		TestResidencyBackend& operator=(TestResidencyBackend&& other) = default;
+
+		void MakeResident(ID3D12Pageable* const* objects, UINT nrOfObjects) override
+		{
+			for (UINT i = 0; i < nrOfObjects; ++i)
+				evicted[objects[i]] = false;
+		}
+
+		void Evict(ID3D12Pageable* const* objects, UINT nrOfObjects) override
+		{
+			for (UINT i = 0; i < nrOfObjects; ++i)
+				evicted[objects[i]] = true;
+
+			nrOfEvictedHeaps += nrOfObjects;
+		}
+
+		bool IsResident(ID3D12Heap* heap)
+		{
+			return evicted[heap] == false;
+		}
+
+		size_t GetNrOfEvictedHeaps() const
+		{
+			return nrOfEvictedHeaps;
+		}
+	};
+
+	constexpr size_t POOL_HEAP_SIZE = 4 * 1024 * 1024;
+	constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+	HeapChunk AllocateDefaultChunk(HeapAllocatorGPU& allocator)
+	{
+		return allocator.AllocateChunk(CHUNK_SIZE, D3D12_HEAP_TYPE_DEFAULT,
+			D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS);
+	}
+
+	void TestSharedPoolHeapIsCountedOnce()
+	{
+		const char* name = "SharedPoolHeapIsCountedOnce";
+		TestResidencyBackend backend;
+		ResidencyManager manager;
+		manager.Initialize(nullptr, 0, 2, &backend);
+		PooledHeapAllocatorGPU<TLSFAllocator> pool;
+		pool.Initialize(nullptr, POOL_HEAP_SIZE, CHUNK_SIZE);
+		ResidencyTrackingHeapAllocatorGPU evictedAllocator(&pool, &manager,
+			manager.CreateResidencySet());
+		ResidencyTrackingHeapAllocatorGPU usedAllocator(&pool, &manager,
+			manager.CreateResidencySet());
+
+		HeapChunk firstChunk = AllocateDefaultChunk(evictedAllocator);
+		HeapChunk secondChunk = AllocateDefaultChunk(evictedAllocator);
+		manager.SwapFrame();
+		HeapChunk thirdChunk = AllocateDefaultChunk(usedAllocator);
+
+		Check(firstChunk.heap == thirdChunk.heap, name, "chunks were not placed in the same pooled heap");
+		Check(manager.GetResidentSize() == POOL_HEAP_SIZE, name, "pooled heap is not counted once at its real size");
+
+		manager.SwapFrame();
+
+		Check(backend.IsResident(firstChunk.heap), name, "heap still used by a resident set was evicted");
+		Check(manager.GetResidentSize() == POOL_HEAP_SIZE, name, "heap still used by a resident set is not counted");
+
+		manager.SwapFrame();
+
+		Check(backend.IsResident(firstChunk.heap) == false, name, "heap was not evicted with its last set");
+		Check(backend.GetNrOfEvictedHeaps() == 1, name, "heap was evicted more than once");
+		Check(manager.GetResidentSize() == 0, name, "evicted heap is still counted as resident");
+
+		usedAllocator.DeallocateChunk(thirdChunk);
+		evictedAllocator.DeallocateChunk(secondChunk);
+		evictedAllocator.DeallocateChunk(firstChunk);
+
+		Check(manager.GetResidentSize() == 0, name, "heap returned to the pool is still counted");
+	}
+
+	void TestSeparatePoolsEvictSeparately()
+	{
+		const char* name = "SeparatePoolsEvictSeparately";
+		TestResidencyBackend backend;
+		ResidencyManager manager;
+		manager.Initialize(nullptr, POOL_HEAP_SIZE, 2, &backend);
+		PooledHeapAllocatorGPU<TLSFAllocator> evictedPool;
+		evictedPool.Initialize(nullptr, POOL_HEAP_SIZE, CHUNK_SIZE);
+		PooledHeapAllocatorGPU<TLSFAllocator> usedPool;
+		usedPool.Initialize(nullptr, POOL_HEAP_SIZE, CHUNK_SIZE);
+		ResidencyTrackingHeapAllocatorGPU evictedAllocator(&evictedPool, &manager,
+			manager.CreateResidencySet());
+		ResidencyTrackingHeapAllocatorGPU usedAllocator(&usedPool, &manager,
+			manager.CreateResidencySet());
+
+		HeapChunk evictedChunk = AllocateDefaultChunk(evictedAllocator);
+		manager.SwapFrame();
+		HeapChunk usedChunk = AllocateDefaultChunk(usedAllocator);
+
+		Check(manager.GetResidentSize() == 2 * POOL_HEAP_SIZE, name, "pooled heaps are not counted at their real size");
+
+		manager.SwapFrame();
+
+		Check(backend.IsResident(evictedChunk.heap) == false, name, "heap of the evicted set is still resident");
+		Check(backend.IsResident(usedChunk.heap), name, "heap of the used set was evicted");
+		Check(manager.GetResidentSize() == POOL_HEAP_SIZE, name, "eviction did not bring the resident size within the budget");
+
+		usedAllocator.DeallocateChunk(usedChunk);
+		evictedAllocator.DeallocateChunk(evictedChunk);
+	}
+}
+
+// The tests do not link the Core library, so heaps are created here instead of through the device
+ID3D12Heap* HeapAllocatorGPU::CreateHeap(size_t heapSize, D3D12_HEAP_TYPE heapType,
+	D3D12_HEAP_FLAGS heapFlags)
+{
+	return new FakeHeap(heapSize, heapType, heapFlags);
+}
+
+void RunPooledHeapResidencyTests()
+{
+	TestSharedPoolHeapIsCountedOnce();
+	TestSeparatePoolsEvictSeparately();
+}
\ No newline at end of file
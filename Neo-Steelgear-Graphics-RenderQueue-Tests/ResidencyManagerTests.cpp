@@ -0,0 +1,143 @@
+#include "Tests.h"
+
+#include <unordered_map>
+
+#include <d3d12.h>
+
+#include <ResidencyManager.h>
+
+namespace
+{
+	// Tracks what the residency manager asks for, and flags calls that would unbalance the residency of a heap
+	class TestResidencyBackend : public ResidencyBackend
+	{
+	private:
+		std::unordered_map<ID3D12Pageable*, bool> evicted;
+		size_t nrOfUnbalancedCalls = 0;
+
+	public:
+		TestResidencyBackend() = default;
+		~TestResidencyBackend() = default;
+		TestResidencyBackend(const TestResidencyBackend& other) = delete;
+		TestResidencyBackend& operator=(const TestResidencyBackend& other) = delete;
+		TestResidencyBackend(TestResidencyBackend&& other) = default;
+		TestResidencyBackend& operator=(TestResidencyBackend&& other) = default;
+
+		void MakeResident(ID3D12Pageable* const* objects, UINT nrOfObjects) override
+		{
+			for (UINT i = 0; i < nrOfObjects; ++i)
+			{
+				if (evicted[objects[i]] == false)
+					++nrOfUnbalancedCalls;
+
+				evicted[objects[i]] = false;
+			}
+		}
+
+		void Evict(ID3D12Pageable* const* objects, UINT nrOfObjects) override
+		{
+			for (UINT i = 0; i < nrOfObjects; ++i)
+			{
+				if (evicted[objects[i]] == true)
+					++nrOfUnbalancedCalls;
+
+				evicted[objects[i]] = true;
+			}
+		}
+
+		bool IsResident(ID3D12Heap* heap)
+		{
+			return evicted[heap] == false;
+		}
+
+		size_t GetNrOfUnbalancedCalls() const
+		{
+			return nrOfUnbalancedCalls;
+		}
+	};
+
+	// The manager never dereferences heaps, so any distinct addresses can stand in for them
+	unsigned char heapStorage[2];
+	ID3D12Heap* const SHARED_HEAP = reinterpret_cast<ID3D12Heap*>(&heapStorage[0]);
+	ID3D12Heap* const UNSHARED_HEAP = reinterpret_cast<ID3D12Heap*>(&heapStorage[1]);
+
+	void TestSharedHeapStaysResident()
+	{
+		const char* name = "SharedHeapStaysResident";
+		TestResidencyBackend backend;
+		ResidencyManager manager;
+		manager.Initialize(nullptr, 0, 2, &backend);
+		size_t evictedSet = manager.CreateResidencySet();
+		size_t usedSet = manager.CreateResidencySet();
+
+		manager.AddHeap(evictedSet, SHARED_HEAP, 64);
+		manager.AddHeap(evictedSet, UNSHARED_HEAP, 32);
+		manager.SwapFrame();
+		manager.AddHeap(usedSet, SHARED_HEAP, 64);
+		manager.SwapFrame();
+
+		Check(manager.IsResident(evictedSet) == false, name, "unused set was not evicted");
+		Check(manager.IsResident(usedSet) == true, name, "used set was evicted");
+		Check(backend.IsResident(UNSHARED_HEAP) == false, name, "heap of the evicted set is still resident");
+		Check(backend.IsResident(SHARED_HEAP) == true, name, "heap used by a resident set was evicted");
+		Check(manager.GetResidentSize() == 64, name, "shared heap is not counted as resident once");
+
+		manager.MarkUsed(evictedSet);
+
+		Check(backend.IsResident(UNSHARED_HEAP) == true, name, "heap was not made resident when its set was used");
+		Check(manager.GetResidentSize() == 96, name, "shared heap was counted twice");
+		Check(backend.GetNrOfUnbalancedCalls() == 0, name, "a heap was made resident or evicted twice");
+	}
+
+	void TestRemovingLastResidentUser()
+	{
+		const char* name = "RemovingLastResidentUser";
+		TestResidencyBackend backend;
+		ResidencyManager manager;
+		manager.Initialize(nullptr, 0, 2, &backend);
+		size_t evictedSet = manager.CreateResidencySet();
+		size_t usedSet = manager.CreateResidencySet();
+
+		manager.AddHeap(evictedSet, SHARED_HEAP, 64);
+		manager.SwapFrame();
+		manager.AddHeap(usedSet, SHARED_HEAP, 64);
+		manager.SwapFrame();
+		manager.RemoveHeap(usedSet, SHARED_HEAP);
+
+		Check(backend.IsResident(SHARED_HEAP) == false, name, "heap only used by an evicted set is still resident");
+		Check(manager.GetResidentSize() == 0, name, "evicted heap is counted as resident");
+
+		manager.AddHeap(usedSet, SHARED_HEAP, 64);
+
+		Check(backend.IsResident(SHARED_HEAP) == true, name, "heap handed out again was not made resident");
+		Check(manager.GetResidentSize() == 64, name, "heap made resident again is not counted once");
+		Check(backend.GetNrOfUnbalancedCalls() == 0, name, "a heap was made resident or evicted twice");
+	}
+
+	void TestRemovingLastUser()
+	{
+		const char* name = "RemovingLastUser";
+		TestResidencyBackend backend;
+		ResidencyManager manager;
+		manager.Initialize(nullptr, 0, 2, &backend);
+		size_t firstSet = manager.CreateResidencySet();
+		size_t secondSet = manager.CreateResidencySet();
+
+		manager.AddHeap(firstSet, SHARED_HEAP, 64);
+		manager.AddHeap(secondSet, SHARED_HEAP, 64);
+		manager.RemoveHeap(firstSet, SHARED_HEAP);
+		manager.RemoveHeap(secondSet, SHARED_HEAP);
+
+		// Heaps handed back to their allocator may be given out again and must stay resident
+		Check(backend.IsResident(SHARED_HEAP) == true, name, "heap returned to its allocator was evicted");
+		Check(manager.GetResidentSize() == 0, name, "removed heap is still counted as resident");
+		Check(backend.GetNrOfUnbalancedCalls() == 0, name, "a heap was made resident or evicted twice");
+	}
+}
+
+void RunResidencyManagerTests()
+{
+	TestSharedHeapStaysResident();
+	TestRemovingLastResidentUser();
+	TestRemovingLastUser();
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "Tests.h"
+
+#include <map>
+#include <iterator>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <stdexcept>
+
+#include <TLSFAllocator.h>
+
+namespace
+{
+	constexpr size_t GRANULARITY = 256;
+	constexpr size_t TOTAL_SIZE = 1024 * 1024;
+
+	void TestAllocationsAreAlignedAndDisjoint()
+	{
+		const char* name = "TLSFAllocationsAreAlignedAndDisjoint";
+		TLSFAllocator allocator;
+		allocator.Initialize(TOTAL_SIZE, GRANULARITY);
+		std::mt19937 generator(7);
+		std::uniform_int_distribution<size_t> sizeDistribution(1, 16 * 1024);
+		std::map<size_t, size_t> allocations;
+		bool aligned = true;
+		bool disjoint = true;
+
+		for (size_t i = 0; i < 20000; ++i)
+		{
+			if (allocations.size() != 0 && generator() % 2 == 0)
+			{
+				auto toRemove = allocations.begin();
+				std::advance(toRemove, generator() % allocations.size());
+				allocator.Deallocate(toRemove->first);
+				allocations.erase(toRemove);
+				continue;
+			}
+
+			size_t size = TLSFAllocator::GetAllocationSize(sizeDistribution(generator), GRANULARITY);
+			size_t offset = allocator.Allocate(size);
+			if (offset == size_t(-1))
+				continue;
+
+			aligned = aligned && offset % GRANULARITY == 0 && offset + size <= TOTAL_SIZE;
+			auto next = allocations.lower_bound(offset);
+			if (next != allocations.end() && next->first < offset + size)
+				disjoint = false;
+			if (next != allocations.begin() && std::prev(next)->first + std::prev(next)->second > offset)
+				disjoint = false;
+
+			allocations[offset] = size;
+		}
+
+		size_t allocatedSize = 0;
+		for (auto& allocation : allocations)
+			allocatedSize += allocation.second;
+
+		Check(aligned, name, "allocation is unaligned or outside of the range");
+		Check(disjoint, name, "allocations overlap");
+		Check(allocator.GetAllocatedSize() == allocatedSize, name, "allocated size is not tracked correctly");
+	}
+
+	void TestFreeingEverythingCoalesces()
+	{
+		const char* name = "TLSFFreeingEverythingCoalesces";
+		TLSFAllocator allocator;
+		allocator.Initialize(TOTAL_SIZE, GRANULARITY);
+		std::mt19937 generator(11);
+		std::vector<size_t> offsets;
+
+		for (size_t offset = allocator.Allocate(GRANULARITY * (1 + generator() % 8));
+			offset != size_t(-1); offset = allocator.Allocate(GRANULARITY * (1 + generator() % 8)))
+		{
+			offsets.push_back(offset);
+		}
+
+		std::shuffle(offsets.begin(), offsets.end(), generator);
+		for (size_t offset : offsets)
+			allocator.Deallocate(offset);
+
+		Check(allocator.GetAllocatedSize() == 0, name, "memory is still allocated");
+		Check(allocator.GetLargestFreeSize() == TOTAL_SIZE, name, "free blocks were not merged");
+		Check(allocator.Allocate(TOTAL_SIZE) == 0, name, "the whole range could not be allocated");
+	}
+
+	void TestExhaustionAndInvalidFree()
+	{
+		const char* name = "TLSFExhaustionAndInvalidFree";
+		TLSFAllocator allocator;
+		allocator.Initialize(4 * GRANULARITY, GRANULARITY);
+
+		Check(allocator.Allocate(5 * GRANULARITY) == size_t(-1), name, "allocation larger than the range succeeded");
+		Check(allocator.Allocate(GRANULARITY + 1) == 0, name, "allocation did not start at the beginning");
+		Check(allocator.Allocate(2 * GRANULARITY) == 2 * GRANULARITY, name, "allocation did not follow the previous one");
+		Check(allocator.Allocate(1) == size_t(-1), name, "allocation succeeded in a full range");
+
+		bool threw = false;
+		try
+		{
+			allocator.Deallocate(GRANULARITY);
+		}
+		catch (const std::runtime_error&)
+		{
+			threw = true;
+		}
+
+		Check(threw, name, "freeing an offset that was never allocated did not throw");
+	}
+}
+
+void RunTLSFAllocatorTests()
+{
+	TestAllocationsAreAlignedAndDisjoint();
+	TestFreeingEverythingCoalesces();
+	TestExhaustionAndInvalidFree();
+}
\ No newline at end of file
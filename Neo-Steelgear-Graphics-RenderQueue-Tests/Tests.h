@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdio>
+#include <cstddef>
+
+// Number of failed checks, main returns non-zero if any check failed
+inline size_t& GetNrOfFailedChecks()
+{
+	static size_t nrOfFailedChecks = 0;
+	return nrOfFailedChecks;
+}
+
+inline void Check(bool condition, const char* testName, const char* description)
+{
+	if (condition)
+		return;
+
+	std::printf("FAILED %s: %s\n", testName, description);
+	++GetNrOfFailedChecks();
+}
+
+void RunResidencyManagerTests();
+void RunTLSFAllocatorTests();
+void RunBuddyAllocatorTests();
+void RunPooledHeapResidencyTests();
\ No newline at end of file
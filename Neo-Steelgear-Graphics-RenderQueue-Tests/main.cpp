@@ -0,0 +1,18 @@
+#include "Tests.h"
+
+int main()
+{
+	RunResidencyManagerTests();
+	RunTLSFAllocatorTests();
+	RunBuddyAllocatorTests();
+	RunPooledHeapResidencyTests();
+
+	if (GetNrOfFailedChecks() != 0)
+	{
+		std::printf("%zu checks failed\n", GetNrOfFailedChecks());
+		return 1;
+	}
+
+	std::printf("All checks passed\n");
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,397 @@
+#include "BitmapDescriptorAllocator.h"
+
+#include <bit>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+	constexpr size_t BITS_PER_WORD = 64;
+	constexpr std::uint64_t FULL_WORD = ~std::uint64_t(0);
+}
+
+void BitmapDescriptorAllocator::CreateHeap(size_t nrOfDescriptors)
+{
+	D3D12_DESCRIPTOR_HEAP_DESC desc;
+	desc.Type = heapData.descriptorType;
+	desc.NumDescriptors = static_cast<UINT>(nrOfDescriptors);
+	desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+	desc.NodeMask = 0;
+
+	ID3D12DescriptorHeap* heap = nullptr;
+	HRESULT hr = device->CreateDescriptorHeap(&desc, IID_PPV_ARGS(&heap));
+	if (FAILED(hr))
+		throw std::runtime_error("Could not create descriptor heap for bitmap descriptor allocator");
+
+	heapData.heapOwned = true;
+	heapData.heap = heap;
+	heapData.heapStart = heap->GetCPUDescriptorHandleForHeapStart();
+	heapData.startIndex = 0;
+	heapData.nrOfDescriptors = nrOfDescriptors;
+}
+
+void BitmapDescriptorAllocator::Expand(size_t minimumNrOfDescriptors)
+{
+	if (!heapData.heapOwned)
+		throw std::runtime_error("Bitmap descriptor allocator ran out of descriptors in external heap");
+
+	ID3D12DescriptorHeap* oldHeap = heapData.heap;
+	D3D12_CPU_DESCRIPTOR_HANDLE oldStart = heapData.heapStart;
+	size_t newSize = heapData.nrOfDescriptors * 2;
+	newSize = newSize < minimumNrOfDescriptors ? minimumNrOfDescriptors : newSize;
+	CreateHeap(newSize);
+
+	if (endOfUsedSlots != 0)
+	{
+		device->CopyDescriptorsSimple(static_cast<UINT>(endOfUsedSlots),
+			heapData.heapStart, oldStart, heapData.descriptorType);
+	}
+
+	replacedHeaps.push_back(oldHeap); // Earlier handles may still be read this frame
+	usedBits.resize((newSize + BITS_PER_WORD - 1) / BITS_PER_WORD, 0);
+	slots.resize(newSize);
+}
+
+size_t BitmapDescriptorAllocator::FindFreeSlot()
+{
+	for (size_t word = firstPossiblyFreeWord; word < usedBits.size(); ++word)
+	{
+		if (usedBits[word] != FULL_WORD)
+		{
+			firstPossiblyFreeWord = word;
+			size_t bit = std::countr_zero(~usedBits[word]);
+			size_t index = word * BITS_PER_WORD + bit;
+
+			if (index < heapData.nrOfDescriptors)
+				return index;
+
+			break;
+		}
+	}
+
+	firstPossiblyFreeWord = usedBits.size();
+	size_t toReturn = heapData.nrOfDescriptors;
+	Expand(toReturn + 1);
+	firstPossiblyFreeWord = toReturn / BITS_PER_WORD;
+	return toReturn;
+}
+
+size_t BitmapDescriptorAllocator::ClaimSlot(size_t indexInHeap)
+{
+	if (indexInHeap == size_t(-1))
+	{
+		indexInHeap = FindFreeSlot();
+	}
+	else if (indexInHeap >= heapData.nrOfDescriptors)
+	{
+		Expand(indexInHeap + 1);
+	}
+
+	std::uint64_t& word = usedBits[indexInHeap / BITS_PER_WORD];
+	std::uint64_t mask = std::uint64_t(1) << (indexInHeap % BITS_PER_WORD);
+
+	if ((word & mask) != 0)
+		ReleaseDescription(slots[indexInHeap]); // Replacing an existing view
+
+	word |= mask;
+	endOfUsedSlots = indexInHeap + 1 > endOfUsedSlots ? indexInHeap + 1 : endOfUsedSlots;
+
+	return indexInHeap;
+}
+
+void BitmapDescriptorAllocator::ReleaseDescription(SlotData& slot)
+{
+	if (slot.descriptionIndex != std::uint32_t(-1))
+	{
+		switch (slot.type)
+		{
+		case DescriptorType::CBV:
+			cbvDescriptions.Remove(slot.descriptionIndex);
+			break;
+		case DescriptorType::SRV:
+			srvDescriptions.Remove(slot.descriptionIndex);
+			break;
+		case DescriptorType::UAV:
+			uavDescriptions.Remove(slot.descriptionIndex);
+			break;
+		case DescriptorType::RTV:
+			rtvDescriptions.Remove(slot.descriptionIndex);
+			break;
+		case DescriptorType::DSV:
+			dsvDescriptions.Remove(slot.descriptionIndex);
+			break;
+		default:
+			break;
+		}
+	}
+
+	slot.type = DescriptorType::NONE;
+	slot.descriptionIndex = std::uint32_t(-1);
+}
+
+void BitmapDescriptorAllocator::ReleaseHeap()
+{
+	if (heapData.heapOwned && heapData.heap != nullptr)
+		heapData.heap->Release();
+
+	heapData.heap = nullptr;
+	heapData.heapOwned = false;
+}
+
+void BitmapDescriptorAllocator::ReleaseReplacedHeaps()
+{
+	for (ID3D12DescriptorHeap* heap : replacedHeaps)
+		heap->Release();
+
+	replacedHeaps.clear();
+}
+
+BitmapDescriptorAllocator::~BitmapDescriptorAllocator()
+{
+	ReleaseHeap();
+	ReleaseReplacedHeaps();
+}
+
+BitmapDescriptorAllocator::BitmapDescriptorAllocator(
+	BitmapDescriptorAllocator&& other) noexcept : heapData(other.heapData),
+	device(other.device), replacedHeaps(std::move(other.replacedHeaps)),
+	usedBits(std::move(other.usedBits)),
+	slots(std::move(other.slots)), firstPossiblyFreeWord(other.firstPossiblyFreeWord),
+	endOfUsedSlots(other.endOfUsedSlots), cbvDescriptions(std::move(other.cbvDescriptions)),
+	srvDescriptions(std::move(other.srvDescriptions)),
+	uavDescriptions(std::move(other.uavDescriptions)),
+	rtvDescriptions(std::move(other.rtvDescriptions)),
+	dsvDescriptions(std::move(other.dsvDescriptions))
+{
+	other.heapData.heap = nullptr;
+	other.heapData.heapOwned = false;
+	other.device = nullptr;
+	other.firstPossiblyFreeWord = 0;
+	other.endOfUsedSlots = 0;
+}
+
+BitmapDescriptorAllocator& BitmapDescriptorAllocator::operator=(
+	BitmapDescriptorAllocator&& other) noexcept
+{
+	if (this != &other)
+	{
+		ReleaseHeap();
+		ReleaseReplacedHeaps();
+		heapData = other.heapData;
+		device = other.device;
+		replacedHeaps = std::move(other.replacedHeaps);
+		usedBits = std::move(other.usedBits);
+		slots = std::move(other.slots);
+		firstPossiblyFreeWord = other.firstPossiblyFreeWord;
+		endOfUsedSlots = other.endOfUsedSlots;
+		cbvDescriptions = std::move(other.cbvDescriptions);
+		srvDescriptions = std::move(other.srvDescriptions);
+		uavDescriptions = std::move(other.uavDescriptions);
+		rtvDescriptions = std::move(other.rtvDescriptions);
+		dsvDescriptions = std::move(other.dsvDescriptions);
+
+		other.heapData.heap = nullptr;
+		other.heapData.heapOwned = false;
+		other.device = nullptr;
+		other.firstPossiblyFreeWord = 0;
+		other.endOfUsedSlots = 0;
+	}
+
+	return *this;
+}
+
+void BitmapDescriptorAllocator::Initialize(D3D12_DESCRIPTOR_HEAP_TYPE descriptorType,
+	ID3D12Device* deviceToUse, ID3D12DescriptorHeap* heap, size_t startIndex,
+	size_t nrOfDescriptors)
+{
+	device = deviceToUse;
+	heapData.heapOwned = false;
+	heapData.heap = heap;
+	heapData.descriptorType = descriptorType;
+	heapData.descriptorSize = device->GetDescriptorHandleIncrementSize(descriptorType);
+	heapData.startIndex = startIndex;
+	heapData.nrOfDescriptors = nrOfDescriptors;
+	heapData.heapStart = heap->GetCPUDescriptorHandleForHeapStart();
+	heapData.heapStart.ptr += startIndex * heapData.descriptorSize;
+
+	usedBits.resize((nrOfDescriptors + BITS_PER_WORD - 1) / BITS_PER_WORD, 0);
+	slots.resize(nrOfDescriptors);
+}
+
+void BitmapDescriptorAllocator::Initialize(D3D12_DESCRIPTOR_HEAP_TYPE descriptorType,
+	ID3D12Device* deviceToUse, size_t startNrOfDescriptors)
+{
+	device = deviceToUse;
+	heapData.descriptorType = descriptorType;
+	heapData.descriptorSize = device->GetDescriptorHandleIncrementSize(descriptorType);
+	CreateHeap(startNrOfDescriptors != 0 ? startNrOfDescriptors : 1);
+
+	usedBits.resize((heapData.nrOfDescriptors + BITS_PER_WORD - 1) / BITS_PER_WORD, 0);
+	slots.resize(heapData.nrOfDescriptors);
+}
+
+size_t BitmapDescriptorAllocator::AllocateSRV(ID3D12Resource* resource,
+	const D3D12_SHADER_RESOURCE_VIEW_DESC* desc, size_t indexInHeap)
+{
+	size_t index = ClaimSlot(indexInHeap);
+	SlotData& slot = slots[index];
+	slot.type = DescriptorType::SRV;
+	slot.descriptionIndex = desc != nullptr ?
+		srvDescriptions.Add(*desc) : std::uint32_t(-1);
+	device->CreateShaderResourceView(resource, desc, GetDescriptorHandle(index));
+
+	return index;
+}
+
+size_t BitmapDescriptorAllocator::AllocateDSV(ID3D12Resource* resource,
+	const D3D12_DEPTH_STENCIL_VIEW_DESC* desc, size_t indexInHeap)
+{
+	size_t index = ClaimSlot(indexInHeap);
+	SlotData& slot = slots[index];
+	slot.type = DescriptorType::DSV;
+	slot.descriptionIndex = desc != nullptr ?
+		dsvDescriptions.Add(*desc) : std::uint32_t(-1);
+	device->CreateDepthStencilView(resource, desc, GetDescriptorHandle(index));
+
+	return index;
+}
+
+size_t BitmapDescriptorAllocator::AllocateRTV(ID3D12Resource* resource,
+	const D3D12_RENDER_TARGET_VIEW_DESC* desc, size_t indexInHeap)
+{
+	size_t index = ClaimSlot(indexInHeap);
+	SlotData& slot = slots[index];
+	slot.type = DescriptorType::RTV;
+	slot.descriptionIndex = desc != nullptr ?
+		rtvDescriptions.Add(*desc) : std::uint32_t(-1);
+	device->CreateRenderTargetView(resource, desc, GetDescriptorHandle(index));
+
+	return index;
+}
+
+size_t BitmapDescriptorAllocator::AllocateUAV(ID3D12Resource* resource,
+	const D3D12_UNORDERED_ACCESS_VIEW_DESC* desc, ID3D12Resource* counterResource,
+	size_t indexInHeap)
+{
+	size_t index = ClaimSlot(indexInHeap);
+	SlotData& slot = slots[index];
+	slot.type = DescriptorType::UAV;
+
+	UnorderedAccessDescription description;
+	description.hasDesc = desc != nullptr;
+	if (desc != nullptr)
+		description.desc = *desc;
+	description.counterResource = counterResource;
+	slot.descriptionIndex = uavDescriptions.Add(description);
+	device->CreateUnorderedAccessView(resource, counterResource, desc,
+		GetDescriptorHandle(index));
+
+	return index;
+}
+
+size_t BitmapDescriptorAllocator::AllocateCBV(
+	const D3D12_CONSTANT_BUFFER_VIEW_DESC* desc, size_t indexInHeap)
+{
+	size_t index = ClaimSlot(indexInHeap);
+	SlotData& slot = slots[index];
+	slot.type = DescriptorType::CBV;
+	slot.descriptionIndex = desc != nullptr ?
+		cbvDescriptions.Add(*desc) : std::uint32_t(-1);
+	device->CreateConstantBufferView(desc, GetDescriptorHandle(index));
+
+	return index;
+}
+
+void BitmapDescriptorAllocator::ReallocateView(size_t indexInHeap,
+	ID3D12Resource* resource)
+{
+	const SlotData& slot = slots[indexInHeap];
+	std::uint32_t descriptionIndex = slot.descriptionIndex;
+	bool hasDescription = descriptionIndex != std::uint32_t(-1);
+	D3D12_CPU_DESCRIPTOR_HANDLE handle = GetDescriptorHandle(indexInHeap);
+
+	switch (slot.type)
+	{
+	case DescriptorType::CBV:
+		device->CreateConstantBufferView(hasDescription ?
+			&cbvDescriptions.descriptions[descriptionIndex] : nullptr, handle);
+		break;
+	case DescriptorType::SRV:
+		device->CreateShaderResourceView(resource, hasDescription ?
+			&srvDescriptions.descriptions[descriptionIndex] : nullptr, handle);
+		break;
+	case DescriptorType::UAV:
+	{
+		const UnorderedAccessDescription& description =
+			uavDescriptions.descriptions[descriptionIndex];
+		device->CreateUnorderedAccessView(resource, description.counterResource,
+			description.hasDesc ? &description.desc : nullptr, handle);
+		break;
+	}
+	case DescriptorType::RTV:
+		device->CreateRenderTargetView(resource, hasDescription ?
+			&rtvDescriptions.descriptions[descriptionIndex] : nullptr, handle);
+		break;
+	case DescriptorType::DSV:
+		device->CreateDepthStencilView(resource, hasDescription ?
+			&dsvDescriptions.descriptions[descriptionIndex] : nullptr, handle);
+		break;
+	default:
+		throw std::runtime_error("Attempting to reallocate view of unused descriptor");
+	}
+}
+
+void BitmapDescriptorAllocator::DeallocateDescriptor(size_t index)
+{
+	size_t wordIndex = index / BITS_PER_WORD;
+	usedBits[wordIndex] &= ~(std::uint64_t(1) << (index % BITS_PER_WORD));
+	ReleaseDescription(slots[index]);
+	firstPossiblyFreeWord = wordIndex < firstPossiblyFreeWord ?
+		wordIndex : firstPossiblyFreeWord;
+
+	if (index + 1 != endOfUsedSlots)
+		return;
+
+	endOfUsedSlots = 0;
+	for (size_t word = wordIndex + 1; word > 0; --word)
+	{
+		if (usedBits[word - 1] != 0)
+		{
+			endOfUsedSlots = (word - 1) * BITS_PER_WORD + BITS_PER_WORD -
+				std::countl_zero(usedBits[word - 1]);
+			break;
+		}
+	}
+}
+
+const D3D12_CPU_DESCRIPTOR_HANDLE BitmapDescriptorAllocator::GetDescriptorHandle(
+	size_t index) const
+{
+	D3D12_CPU_DESCRIPTOR_HANDLE toReturn = heapData.heapStart;
+	toReturn.ptr += index * heapData.descriptorSize;
+	return toReturn;
+}
+
+size_t BitmapDescriptorAllocator::NrOfStoredDescriptors() const
+{
+	return endOfUsedSlots;
+}
+
+void BitmapDescriptorAllocator::Reset()
+{
+	size_t usedWords = (endOfUsedSlots + BITS_PER_WORD - 1) / BITS_PER_WORD;
+	for (size_t word = 0; word < usedWords; ++word)
+		usedBits[word] = 0;
+
+	for (size_t i = 0; i < endOfUsedSlots; ++i)
+		slots[i] = SlotData();
+
+	cbvDescriptions.Clear();
+	srvDescriptions.Clear();
+	uavDescriptions.Clear();
+	rtvDescriptions.Clear();
+	dsvDescriptions.Clear();
+	firstPossiblyFreeWord = 0;
+	endOfUsedSlots = 0;
+	ReleaseReplacedHeaps();
+}
\ No newline at end of file
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <d3d12.h>
+
+class BitmapDescriptorAllocator
+{
+private:
+	enum class DescriptorType : std::uint8_t
+	{
+		NONE,
+		CBV,
+		SRV,
+		UAV,
+		RTV,
+		DSV
+	};
+
+	struct DescriptorHeapData
+	{
+		bool heapOwned = false;
+		ID3D12DescriptorHeap* heap = nullptr;
+		D3D12_CPU_DESCRIPTOR_HANDLE heapStart = { 0 };
+		D3D12_DESCRIPTOR_HEAP_TYPE descriptorType =
+			D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+		size_t descriptorSize = 0;
+		size_t startIndex = 0;
+		size_t nrOfDescriptors = 0;
+	} heapData;
+
+	// Hot per slot data, view descriptions live in separate pools and are only touched when recreating views
+	struct SlotData
+	{
+		DescriptorType type = DescriptorType::NONE;
+		std::uint32_t descriptionIndex = std::uint32_t(-1);
+	};
+
+	struct UnorderedAccessDescription
+	{
+		D3D12_UNORDERED_ACCESS_VIEW_DESC desc;
+		bool hasDesc = false;
+		ID3D12Resource* counterResource = nullptr;
+	};
+
+	template<typename T>
+	struct DescriptionPool
+	{
+		std::vector<T> descriptions;
+		std::vector<std::uint32_t> freeIndices;
+
+		std::uint32_t Add(const T& description);
+		void Remove(std::uint32_t index);
+		void Clear();
+	};
+
+	ID3D12Device* device = nullptr;
+	std::vector<ID3D12DescriptorHeap*> replacedHeaps;
+	std::vector<std::uint64_t> usedBits;
+	std::vector<SlotData> slots;
+	size_t firstPossiblyFreeWord = 0;
+	size_t endOfUsedSlots = 0;
+
+	DescriptionPool<D3D12_CONSTANT_BUFFER_VIEW_DESC> cbvDescriptions;
+	DescriptionPool<D3D12_SHADER_RESOURCE_VIEW_DESC> srvDescriptions;
+	DescriptionPool<UnorderedAccessDescription> uavDescriptions;
+	DescriptionPool<D3D12_RENDER_TARGET_VIEW_DESC> rtvDescriptions;
+	DescriptionPool<D3D12_DEPTH_STENCIL_VIEW_DESC> dsvDescriptions;
+
+	void CreateHeap(size_t nrOfDescriptors);
+	void Expand(size_t minimumNrOfDescriptors);
+	size_t FindFreeSlot();
+	size_t ClaimSlot(size_t indexInHeap);
+	void ReleaseDescription(SlotData& slot);
+	void ReleaseHeap();
+	void ReleaseReplacedHeaps();
+
+public:
+	BitmapDescriptorAllocator() = default;
+	~BitmapDescriptorAllocator();
+	BitmapDescriptorAllocator(const BitmapDescriptorAllocator& other) = delete;
+	BitmapDescriptorAllocator& operator=(const BitmapDescriptorAllocator& other) = delete;
+	BitmapDescriptorAllocator(BitmapDescriptorAllocator&& other) noexcept;
+	BitmapDescriptorAllocator& operator=(BitmapDescriptorAllocator&& other) noexcept;
+
+	void Initialize(D3D12_DESCRIPTOR_HEAP_TYPE descriptorType, ID3D12Device* deviceToUse,
+		ID3D12DescriptorHeap* heap, size_t startIndex, size_t nrOfDescriptors);
+	void Initialize(D3D12_DESCRIPTOR_HEAP_TYPE descriptorType,
+		ID3D12Device* deviceToUse, size_t startNrOfDescriptors);
+
+	size_t AllocateSRV(ID3D12Resource* resource,
+		const D3D12_SHADER_RESOURCE_VIEW_DESC* desc = nullptr,
+		size_t indexInHeap = size_t(-1));
+	size_t AllocateDSV(ID3D12Resource* resource,
+		const D3D12_DEPTH_STENCIL_VIEW_DESC* desc = nullptr,
+		size_t indexInHeap = size_t(-1));
+	size_t AllocateRTV(ID3D12Resource* resource,
+		const D3D12_RENDER_TARGET_VIEW_DESC* desc = nullptr,
+		size_t indexInHeap = size_t(-1));
+	size_t AllocateUAV(ID3D12Resource* resource,
+		const D3D12_UNORDERED_ACCESS_VIEW_DESC* desc = nullptr,
+		ID3D12Resource* counterResource = nullptr,
+		size_t indexInHeap = size_t(-1));
+	size_t AllocateCBV(
+		const D3D12_CONSTANT_BUFFER_VIEW_DESC* desc = nullptr,
+		size_t indexInHeap = size_t(-1));
+
+	void ReallocateView(size_t indexInHeap, ID3D12Resource* resource);
+
+	void DeallocateDescriptor(size_t index);
+
+	const D3D12_CPU_DESCRIPTOR_HANDLE GetDescriptorHandle(size_t index) const;
+	size_t NrOfStoredDescriptors() const;
+
+	// Heaps replaced when expanding are kept until then, so handles given out earlier stay valid
+	void Reset();
+};
+
+template<typename T>
+inline std::uint32_t BitmapDescriptorAllocator::DescriptionPool<T>::Add(
+	const T& description)
+{
+	if (!freeIndices.empty())
+	{
+		std::uint32_t toReturn = freeIndices.back();
+		freeIndices.pop_back();
+		descriptions[toReturn] = description;
+		return toReturn;
+	}
+
+	descriptions.push_back(description);
+	return static_cast<std::uint32_t>(descriptions.size() - 1);
+}
+
+template<typename T>
+inline void BitmapDescriptorAllocator::DescriptionPool<T>::Remove(
+	std::uint32_t index)
+{
+	freeIndices.push_back(index);
+}
+
+template<typename T>
+inline void BitmapDescriptorAllocator::DescriptionPool<T>::Clear()
+{
+	descriptions.clear();
+	freeIndices.clear();
+}
\ No newline at end of file
@@ -39,6 +39,7 @@ public:
     TransientResourceIndex CreateTransientResource(
         const TransientResourceDesc& desc, D3D12_RESOURCE_STATES initialState);
     LocalResourceIndex CreateLocalResource(const LocalResourceDesc& desc);
+    LocalResourceIndex CreateLocalResource(const LocalResourcePlacement& placement);
 
     ViewIdentifier CreateSRV(const TransientResourceIndex& index,
         const std::optional<D3D12_SHADER_RESOURCE_VIEW_DESC>& desc = std::nullopt);
@@ -90,6 +91,13 @@ LocalResourceIndex Blackboard<Frames>::CreateLocalResource(const LocalResourceDe
     return localAllocator.CreateLocalResource(desc);
 }
 
+template<FrameType Frames>
+LocalResourceIndex Blackboard<Frames>::CreateLocalResource(
+    const LocalResourcePlacement& placement)
+{
+    return localAllocator.CreateLocalResource(placement);
+}
+
 template<FrameType Frames>
 ViewIdentifier Blackboard<Frames>::CreateSRV(const TransientResourceIndex& index,
     const std::optional<D3D12_SHADER_RESOURCE_VIEW_DESC>& desc)
@@ -0,0 +1,132 @@
+#include "BuddyAllocator.h"
+
+#include <bit>
+#include <stdexcept>
+
+std::uint8_t BuddyAllocator::CombineChildren(size_t nodeIndex,
+	std::uint8_t nodeOrder) const
+{
+	std::uint8_t left = largestFreeOrders[nodeIndex * 2 + 1];
+	std::uint8_t right = largestFreeOrders[nodeIndex * 2 + 2];
+
+	// Two whole free children merge back into one free block
+	if (left == nodeOrder && right == nodeOrder)
+		return static_cast<std::uint8_t>(nodeOrder + 1);
+
+	return left > right ? left : right;
+}
+
+void BuddyAllocator::UpdateParents(size_t nodeIndex, std::uint8_t nodeOrder)
+{
+	while (nodeIndex != 0)
+	{
+		nodeIndex = (nodeIndex - 1) / 2;
+		++nodeOrder;
+		largestFreeOrders[nodeIndex] = CombineChildren(nodeIndex, nodeOrder);
+	}
+}
+
+size_t BuddyAllocator::GetAllocationSize(size_t size, size_t minimumBlockSize)
+{
+	size_t blockSize = std::bit_ceil(size == 0 ? size_t(1) : size);
+	return blockSize < minimumBlockSize ? minimumBlockSize : blockSize;
+}
+
+void BuddyAllocator::Initialize(size_t size, size_t minimumBlockSizeToUse)
+{
+	if (!std::has_single_bit(minimumBlockSizeToUse))
+		throw std::runtime_error("Buddy allocator minimum block size must be a power of two");
+
+	minimumBlockSize = minimumBlockSizeToUse;
+	totalSize = size < minimumBlockSize ? 0 : std::bit_floor(size);
+	allocatedSize = 0;
+	largestFreeOrders.clear();
+
+	if (totalSize == 0)
+		return;
+
+	size_t nrOfLeaves = totalSize / minimumBlockSize;
+	maxOrder = static_cast<std::uint8_t>(std::countr_zero(nrOfLeaves));
+	largestFreeOrders.resize(nrOfLeaves * 2 - 1);
+
+	// Every node starts out as one whole free block of its own order
+	size_t nodeIndex = 0;
+	for (size_t depth = 0; depth <= maxOrder; ++depth)
+	{
+		std::uint8_t freeOrder = static_cast<std::uint8_t>(maxOrder - depth + 1);
+
+		for (size_t i = 0; i < (size_t(1) << depth); ++i)
+			largestFreeOrders[nodeIndex++] = freeOrder;
+	}
+}
+
+size_t BuddyAllocator::Allocate(size_t size)
+{
+	size_t blockSize = GetAllocationSize(size, minimumBlockSize);
+	if (totalSize == 0 || blockSize > totalSize)
+		return size_t(-1);
+
+	std::uint8_t order = static_cast<std::uint8_t>(
+		std::countr_zero(blockSize / minimumBlockSize));
+	if (largestFreeOrders[0] < order + 1)
+		return size_t(-1);
+
+	size_t nodeIndex = 0;
+	for (std::uint8_t nodeOrder = maxOrder; nodeOrder != order; --nodeOrder)
+	{
+		size_t left = nodeIndex * 2 + 1;
+		nodeIndex = largestFreeOrders[left] >= order + 1 ? left : left + 1;
+	}
+
+	largestFreeOrders[nodeIndex] = 0;
+	UpdateParents(nodeIndex, order);
+	allocatedSize += blockSize;
+
+	size_t firstNodeOfOrder = (size_t(1) << (maxOrder - order)) - 1;
+	return (nodeIndex - firstNodeOfOrder) * blockSize;
+}
+
+void BuddyAllocator::Deallocate(size_t offset)
+{
+	if (offset >= totalSize || offset % minimumBlockSize != 0)
+		throw std::runtime_error("Attempting to deallocate an offset outside of the buddy allocator");
+
+	// Nodes below an allocated block are left as they were, so the first empty node above the leaf is the block
+	size_t nodeIndex = offset / minimumBlockSize + (totalSize / minimumBlockSize - 1);
+	std::uint8_t order = 0;
+
+	while (largestFreeOrders[nodeIndex] != 0)
+	{
+		if (nodeIndex == 0)
+			throw std::runtime_error("Attempting to deallocate an offset that is not allocated from the buddy allocator");
+
+		nodeIndex = (nodeIndex - 1) / 2;
+		++order;
+	}
+
+	size_t blockSize = minimumBlockSize << order;
+	if (offset % blockSize != 0)
+		throw std::runtime_error("Attempting to deallocate an offset that is not the start of a buddy block");
+
+	largestFreeOrders[nodeIndex] = static_cast<std::uint8_t>(order + 1);
+	UpdateParents(nodeIndex, order);
+	allocatedSize -= blockSize;
+}
+
+size_t BuddyAllocator::GetTotalSize() const
+{
+	return totalSize;
+}
+
+size_t BuddyAllocator::GetAllocatedSize() const
+{
+	return allocatedSize;
+}
+
+size_t BuddyAllocator::GetLargestFreeSize() const
+{
+	if (totalSize == 0 || largestFreeOrders[0] == 0)
+		return 0;
+
+	return minimumBlockSize << (largestFreeOrders[0] - 1);
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+// Binary buddy allocator over a power of two range of offsets, allocations are rounded up to powers of two
+class BuddyAllocator
+{
+private:
+	// Implicit binary tree with the whole range at the root and minimum sized blocks as leaves.
+	// Each node holds the order of the largest free block below it plus one, zero if nothing is free
+	std::vector<std::uint8_t> largestFreeOrders;
+	size_t minimumBlockSize = 1;
+	size_t totalSize = 0;
+	size_t allocatedSize = 0;
+	std::uint8_t maxOrder = 0;
+
+	std::uint8_t CombineChildren(size_t nodeIndex, std::uint8_t nodeOrder) const;
+	void UpdateParents(size_t nodeIndex, std::uint8_t nodeOrder);
+
+public:
+	BuddyAllocator() = default;
+	~BuddyAllocator() = default;
+	BuddyAllocator(const BuddyAllocator& other) = default;
+	BuddyAllocator& operator=(const BuddyAllocator& other) = default;
+	BuddyAllocator(BuddyAllocator&& other) = default;
+	BuddyAllocator& operator=(BuddyAllocator&& other) = default;
+
+	static size_t GetAllocationSize(size_t size, size_t minimumBlockSize);
+
+	// The minimum block size must be a power of two, the range is rounded down to a power of two
+	void Initialize(size_t size, size_t minimumBlockSizeToUse);
+
+	// Returns size_t(-1) if no free block is large enough
+	size_t Allocate(size_t size);
+	void Deallocate(size_t offset);
+
+	size_t GetTotalSize() const;
+	size_t GetAllocatedSize() const;
+	size_t GetLargestFreeSize() const;
+};
\ No newline at end of file
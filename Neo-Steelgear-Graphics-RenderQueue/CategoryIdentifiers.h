@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 #include <ResourceComponent.h>
 
 enum class CategoryType
@@ -15,6 +17,7 @@ struct CategoryIdentifier
 	CategoryType type;
 	size_t localIndex = size_t(-1);
 	bool dynamicCategory = true;
+	std::uint32_t denseIndex = std::uint32_t(-1); // Assigned on creation, indexes flat per category arrays
 
 	bool operator==(const CategoryIdentifier& other) const
 	{
@@ -23,6 +26,12 @@ struct CategoryIdentifier
 	}
 };
 
+// Mixes each value into the seed so small and equal fields do not cancel out like a plain xor
+inline size_t CombineHash(size_t seed, size_t valueHash)
+{
+	return seed ^ (valueHash + size_t(0x9e3779b9) + (seed << 6) + (seed >> 2));
+}
+
 namespace std
 {
 	template <>
@@ -30,9 +39,9 @@ namespace std
 	{
 		size_t operator()(const CategoryIdentifier& identifier) const
 		{
-			return ((hash<CategoryType>()(identifier.type)
-				^ (hash<size_t>()(identifier.localIndex) << 1)) >> 1)
-				^ (hash<bool>()(identifier.dynamicCategory) << 1);
+			size_t toReturn = hash<CategoryType>()(identifier.type);
+			toReturn = CombineHash(toReturn, hash<size_t>()(identifier.localIndex));
+			return CombineHash(toReturn, hash<bool>()(identifier.dynamicCategory));
 		}
 	};
 }
@@ -52,4 +61,22 @@ struct CategoryResourceIdentifier
 			internalIndex.descriptorIndex == other.internalIndex.descriptorIndex;
 		// Temporary implementation, can be made default once the internal types have op== implemented
 	}
-};
\ No newline at end of file
+};
+
+namespace std
+{
+	template <>
+	struct hash<CategoryResourceIdentifier>
+	{
+		size_t operator()(const CategoryResourceIdentifier& identifier) const
+		{
+			const ResourceIndex& index = identifier.internalIndex;
+			size_t toReturn = hash<CategoryIdentifier>()(identifier.categoryIdentifier);
+			toReturn = CombineHash(toReturn,
+				hash<size_t>()(index.allocatorIdentifier.heapChunkIndex));
+			toReturn = CombineHash(toReturn,
+				hash<size_t>()(index.allocatorIdentifier.internalIndex));
+			return CombineHash(toReturn, hash<size_t>()(index.descriptorIndex));
+		}
+	};
+}
\ No newline at end of file
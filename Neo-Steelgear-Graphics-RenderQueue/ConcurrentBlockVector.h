@@ -0,0 +1,158 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <stdexcept>
+
+template<typename T, size_t BlockSize = 256, size_t MaxBlocks = 1024>
+class ConcurrentBlockVector
+{
+private:
+	struct Block
+	{
+		std::array<T, BlockSize> elements;
+	};
+
+	std::array<std::atomic<Block*>, MaxBlocks> blocks = {};
+	std::atomic<size_t> nrOfElements = 0;
+
+	Block* GetOrCreateBlock(size_t blockIndex);
+	void ReleaseBlocks();
+
+public:
+	ConcurrentBlockVector() = default;
+	~ConcurrentBlockVector();
+	ConcurrentBlockVector(const ConcurrentBlockVector& other) = delete;
+	ConcurrentBlockVector& operator=(const ConcurrentBlockVector& other) = delete;
+	ConcurrentBlockVector(ConcurrentBlockVector&& other) noexcept;
+	ConcurrentBlockVector& operator=(ConcurrentBlockVector&& other) noexcept;
+
+	size_t ReserveRange(size_t nrToReserve);
+	size_t Add(const T& element);
+
+	T& operator[](size_t index);
+	const T& operator[](size_t index) const;
+
+	size_t Size() const;
+	void Clear();
+};
+
+template<typename T, size_t BlockSize, size_t MaxBlocks>
+inline typename ConcurrentBlockVector<T, BlockSize, MaxBlocks>::Block*
+ConcurrentBlockVector<T, BlockSize, MaxBlocks>::GetOrCreateBlock(size_t blockIndex)
+{
+	if (blockIndex >= MaxBlocks)
+		throw std::runtime_error("Concurrent block vector ran out of blocks");
+
+	Block* block = blocks[blockIndex].load(std::memory_order_acquire);
+
+	if (block == nullptr)
+	{
+		Block* newBlock = new Block();
+
+		if (blocks[blockIndex].compare_exchange_strong(block, newBlock,
+			std::memory_order_acq_rel, std::memory_order_acquire))
+		{
+			block = newBlock;
+		}
+		else
+		{
+			delete newBlock; // Another thread got there first
+		}
+	}
+
+	return block;
+}
+
+template<typename T, size_t BlockSize, size_t MaxBlocks>
+inline void ConcurrentBlockVector<T, BlockSize, MaxBlocks>::ReleaseBlocks()
+{
+	for (auto& block : blocks)
+		delete block.exchange(nullptr);
+}
+
+template<typename T, size_t BlockSize, size_t MaxBlocks>
+inline ConcurrentBlockVector<T, BlockSize, MaxBlocks>::~ConcurrentBlockVector()
+{
+	ReleaseBlocks();
+}
+
+template<typename T, size_t BlockSize, size_t MaxBlocks>
+inline ConcurrentBlockVector<T, BlockSize, MaxBlocks>::ConcurrentBlockVector(
+	ConcurrentBlockVector&& other) noexcept : nrOfElements(other.nrOfElements.load())
+{
+	for (size_t i = 0; i < MaxBlocks; ++i)
+		blocks[i].store(other.blocks[i].exchange(nullptr));
+
+	other.nrOfElements = 0;
+}
+
+template<typename T, size_t BlockSize, size_t MaxBlocks>
+inline ConcurrentBlockVector<T, BlockSize, MaxBlocks>&
+ConcurrentBlockVector<T, BlockSize, MaxBlocks>::operator=(
+	ConcurrentBlockVector&& other) noexcept
+{
+	if (this != &other)
+	{
+		ReleaseBlocks();
+
+		for (size_t i = 0; i < MaxBlocks; ++i)
+			blocks[i].store(other.blocks[i].exchange(nullptr));
+
+		nrOfElements = other.nrOfElements.exchange(0);
+	}
+
+	return *this;
+}
+
+template<typename T, size_t BlockSize, size_t MaxBlocks>
+inline size_t ConcurrentBlockVector<T, BlockSize, MaxBlocks>::ReserveRange(
+	size_t nrToReserve)
+{
+	size_t firstIndex = nrOfElements.fetch_add(nrToReserve, std::memory_order_relaxed);
+
+	if (nrToReserve != 0)
+	{
+		size_t lastBlock = (firstIndex + nrToReserve - 1) / BlockSize;
+		for (size_t i = firstIndex / BlockSize; i <= lastBlock; ++i)
+			GetOrCreateBlock(i);
+	}
+
+	return firstIndex;
+}
+
+template<typename T, size_t BlockSize, size_t MaxBlocks>
+inline size_t ConcurrentBlockVector<T, BlockSize, MaxBlocks>::Add(const T& element)
+{
+	size_t index = ReserveRange(1);
+	(*this)[index] = element;
+
+	return index;
+}
+
+template<typename T, size_t BlockSize, size_t MaxBlocks>
+inline T& ConcurrentBlockVector<T, BlockSize, MaxBlocks>::operator[](size_t index)
+{
+	Block* block = blocks[index / BlockSize].load(std::memory_order_acquire);
+	return block->elements[index % BlockSize];
+}
+
+template<typename T, size_t BlockSize, size_t MaxBlocks>
+inline const T& ConcurrentBlockVector<T, BlockSize, MaxBlocks>::operator[](
+	size_t index) const
+{
+	const Block* block = blocks[index / BlockSize].load(std::memory_order_acquire);
+	return block->elements[index % BlockSize];
+}
+
+template<typename T, size_t BlockSize, size_t MaxBlocks>
+inline size_t ConcurrentBlockVector<T, BlockSize, MaxBlocks>::Size() const
+{
+	return nrOfElements.load(std::memory_order_acquire);
+}
+
+template<typename T, size_t BlockSize, size_t MaxBlocks>
+inline void ConcurrentBlockVector<T, BlockSize, MaxBlocks>::Clear()
+{
+	nrOfElements.store(0, std::memory_order_release); // Blocks are kept for reuse
+}
\ No newline at end of file
@@ -25,6 +25,8 @@ public:
 		const CategoryResourceIdentifier& identifier, ViewType viewType) const;
 	unsigned int GetCategoryResourceDescriptor(
 		const CategoryResourceIdentifier& identifier, ViewType viewType) const;
+	unsigned int GetBindlessResourceDescriptor(
+		const CategoryResourceIdentifier& identifier, ViewType viewType) const;
 };
 
 template<FrameType Frames>
@@ -58,4 +60,11 @@ inline unsigned int FramePreparationContext<Frames>::GetCategoryResourceDescript
 	toReturn += identifier.internalIndex.descriptorIndex;
 
 	return toReturn;
+}
+
+template<FrameType Frames>
+inline unsigned int FramePreparationContext<Frames>::GetBindlessResourceDescriptor(
+	const CategoryResourceIdentifier& identifier, ViewType viewType) const
+{
+	return descriptorHeap->GetBindlessDescriptor(identifier, viewType);
 }
\ No newline at end of file
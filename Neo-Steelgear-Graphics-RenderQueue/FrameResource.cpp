@@ -1,5 +1,15 @@
 #include "FrameResource.h"
 
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+	constexpr std::uint32_t MAX_MIPS = 16;
+	constexpr std::uint32_t MAX_ARRAY_SLICES = 2048;
+	constexpr std::uint32_t KEY_END = MAX_MIPS * MAX_ARRAY_SLICES;
+}
+
 bool FrameResource::IsWriteState(D3D12_RESOURCE_STATES state) const
 {
 	switch (state)
@@ -20,24 +30,137 @@ bool FrameResource::IsWriteState(D3D12_RESOURCE_STATES state) const
 	}
 }
 
-FrameResource::FrameResource(const FrameResourceIdentifier& identifier) :
-	identifier(identifier)
+bool FrameResource::TransitionRequired(D3D12_RESOURCE_STATES currentState,
+	D3D12_RESOURCE_STATES newState) const
 {
-	// EMPTY
+	return currentState != D3D12_RESOURCE_STATE_COMMON &&
+		(IsWriteState(currentState) || IsWriteState(newState)) &&
+		currentState != newState;
 }
 
-std::optional<FrameResourceBarrier> FrameResource::UpdateState(D3D12_RESOURCE_STATES newState)
+void FrameResource::GetKeyIntervals(const SubresourceRange& range,
+	std::vector<KeyInterval>& intervals) const
 {
+	if (range.firstMip >= MAX_MIPS || range.nrOfMips == 0)
+		throw std::runtime_error("Subresource range has an invalid mip range");
+
+	if (range.firstArraySlice >= MAX_ARRAY_SLICES || range.nrOfArraySlices == 0)
+		throw std::runtime_error("Subresource range has an invalid array slice range");
+
+	std::uint32_t mipEnd = range.nrOfMips == SubresourceRange::ALL ? MAX_MIPS :
+		std::min<std::uint32_t>(range.firstMip + range.nrOfMips, MAX_MIPS);
+	std::uint32_t sliceEnd = range.nrOfArraySlices == SubresourceRange::ALL ?
+		MAX_ARRAY_SLICES : std::min<std::uint32_t>(
+			range.firstArraySlice + range.nrOfArraySlices, MAX_ARRAY_SLICES);
+
+	if (range.firstArraySlice == 0 && sliceEnd == MAX_ARRAY_SLICES)
+	{
+		intervals.push_back({ range.firstMip * MAX_ARRAY_SLICES,
+			mipEnd * MAX_ARRAY_SLICES });
+		return;
+	}
+
+	for (std::uint32_t mip = range.firstMip; mip < mipEnd; ++mip)
+	{
+		intervals.push_back({ mip * MAX_ARRAY_SLICES + range.firstArraySlice,
+			mip * MAX_ARRAY_SLICES + sliceEnd });
+	}
+}
+
+std::uint32_t FrameResource::GetRunEnd(size_t runIndex) const
+{
+	return runIndex + 1 < stateRuns.size() ?
+		stateRuns[runIndex + 1].startKey : KEY_END;
+}
+
+void FrameResource::SetState(const KeyInterval& keys, D3D12_RESOURCE_STATES state)
+{
+	size_t firstRun = 0;
+	while (GetRunEnd(firstRun) <= keys.startKey)
+		++firstRun;
+
+	size_t lastRun = firstRun;
+	while (GetRunEnd(lastRun) < keys.endKey)
+		++lastRun;
+
+	D3D12_RESOURCE_STATES stateAfter = stateRuns[lastRun].state;
+	std::uint32_t runEnd = GetRunEnd(lastRun);
+	std::vector<StateRun> replacement;
+
+	if (stateRuns[firstRun].startKey < keys.startKey)
+		replacement.push_back(stateRuns[firstRun]);
+
+	replacement.push_back({ keys.startKey, state });
+
+	if (keys.endKey < runEnd)
+		replacement.push_back({ keys.endKey, stateAfter });
+
+	stateRuns.erase(stateRuns.begin() + firstRun, stateRuns.begin() + lastRun + 1);
+	stateRuns.insert(stateRuns.begin() + firstRun, replacement.begin(), replacement.end());
+
+	size_t coalesceStart = firstRun > 0 ? firstRun - 1 : 0;
+	size_t coalesceEnd = std::min<size_t>(firstRun + replacement.size() + 1,
+		stateRuns.size());
+	for (size_t i = coalesceEnd - 1; i > coalesceStart; --i)
+	{
+		if (stateRuns[i].state == stateRuns[i - 1].state)
+			stateRuns.erase(stateRuns.begin() + i);
+	}
+}
+
+void FrameResource::AddTransitionBarriers(const KeyInterval& keys,
+	D3D12_RESOURCE_STATES stateBefore, D3D12_RESOURCE_STATES stateAfter,
+	std::vector<FrameResourceBarrier>& barriers) const
+{
+	std::uint32_t currentKey = keys.startKey;
+
+	while (currentKey < keys.endKey)
+	{
+		std::uint32_t mip = currentKey / MAX_ARRAY_SLICES;
+		std::uint32_t slice = currentKey % MAX_ARRAY_SLICES;
+		std::uint32_t mipKeyEnd = (mip + 1) * MAX_ARRAY_SLICES;
+		SubresourceRange range;
+		range.firstMip = static_cast<std::uint16_t>(mip);
+
+		if (slice == 0 && keys.endKey >= mipKeyEnd)
+		{
+			std::uint32_t nrOfMips = keys.endKey / MAX_ARRAY_SLICES - mip;
+			range.nrOfMips = keys.endKey == KEY_END ? SubresourceRange::ALL :
+				static_cast<std::uint16_t>(nrOfMips);
+			currentKey = (mip + nrOfMips) * MAX_ARRAY_SLICES;
+		}
+		else
+		{
+			std::uint32_t sliceEnd = std::min<std::uint32_t>(keys.endKey, mipKeyEnd) -
+				mip * MAX_ARRAY_SLICES;
+			range.nrOfMips = 1;
+			range.firstArraySlice = static_cast<std::uint16_t>(slice);
+			range.nrOfArraySlices = sliceEnd == MAX_ARRAY_SLICES ?
+				SubresourceRange::ALL : static_cast<std::uint16_t>(sliceEnd - slice);
+			currentKey = mip * MAX_ARRAY_SLICES + sliceEnd;
+		}
+
+		FrameResourceBarrier toAdd;
+		toAdd.InitializeAsTransition(identifier, stateBefore, stateAfter, range);
+		barriers.push_back(std::move(toAdd));
+	}
+}
+
+bool FrameResource::UpdateWholeResourceState(D3D12_RESOURCE_STATES newState,
+	std::vector<FrameResourceBarrier>& barriers)
+{
+	D3D12_RESOURCE_STATES& currentState = stateRuns.front().state;
+
 	if (currentState == newState && currentState == D3D12_RESOURCE_STATE_UNORDERED_ACCESS)
 	{
 		// UAV to UAV, needs an UAV barrier
-		FrameResourceBarrier toReturn;
-		toReturn.InitializeAsUAV(identifier);
-		return toReturn;
+		FrameResourceBarrier toAdd;
+		toAdd.InitializeAsUAV(identifier);
+		barriers.push_back(std::move(toAdd));
+		lastBarrierMergeable = false;
+		return false;
 	}
-	else if (currentState != D3D12_RESOURCE_STATE_COMMON &&
-		(IsWriteState(currentState) || IsWriteState(newState)) &&
-		currentState != newState)
+	else if (TransitionRequired(currentState, newState))
 	{
 		// States are NOT compatible, transition required
 
@@ -47,30 +170,166 @@ std::optional<FrameResourceBarrier> FrameResource::UpdateState(D3D12_RESOURCE_ST
 			initialTransitionPerformed = true;
 		}
 
-		FrameResourceBarrier toReturn;
-		toReturn.InitializeAsTransition(identifier, currentState, newState);
-
+		FrameResourceBarrier toAdd;
+		toAdd.InitializeAsTransition(identifier, currentState, newState);
+		barriers.push_back(std::move(toAdd));
 		currentState = newState;
-
-		return toReturn;
+		lastBarrierMergeable = true;
+		return false;
 	}
 
 	// States are compatible/promotable
+	bool mergeable = initialTransitionPerformed == false || lastBarrierMergeable;
+	bool newStatesAdded = (currentState | newState) != currentState;
+
+	if (!mergeable && newStatesAdded && currentState != D3D12_RESOURCE_STATE_COMMON)
+	{
+		// The last barrier only covered part of the resource, so add to the state explicitly
+		FrameResourceBarrier toAdd;
+		toAdd.InitializeAsTransition(identifier, currentState, currentState | newState);
+		barriers.push_back(std::move(toAdd));
+		currentState |= newState;
+		lastBarrierMergeable = true;
+		return false;
+	}
+
 	currentState |= newState;
-	return std::nullopt;
+	return mergeable;
+}
+
+void FrameResource::UpdateSubresourceStates(D3D12_RESOURCE_STATES newState,
+	std::vector<FrameResourceBarrier>& barriers, const SubresourceRange& range)
+{
+	std::vector<KeyInterval> intervals;
+	GetKeyIntervals(range, intervals);
+	std::vector<StateChange> changes;
+	bool uavBarrierNeeded = false;
+
+	for (const KeyInterval& interval : intervals)
+	{
+		size_t runIndex = 0;
+		while (GetRunEnd(runIndex) <= interval.startKey)
+			++runIndex;
+
+		for (; runIndex < stateRuns.size() &&
+			stateRuns[runIndex].startKey < interval.endKey; ++runIndex)
+		{
+			StateChange change;
+			change.keys.startKey = std::max<std::uint32_t>(
+				stateRuns[runIndex].startKey, interval.startKey);
+			change.keys.endKey = std::min<std::uint32_t>(
+				GetRunEnd(runIndex), interval.endKey);
+			change.stateBefore = stateRuns[runIndex].state;
+
+			if (change.stateBefore == newState &&
+				newState == D3D12_RESOURCE_STATE_UNORDERED_ACCESS)
+			{
+				uavBarrierNeeded = true;
+				continue;
+			}
+			else if (TransitionRequired(change.stateBefore, newState))
+			{
+				change.stateAfter = newState;
+				change.barrierNeeded = true;
+			}
+			else
+			{
+				change.stateAfter = change.stateBefore | newState;
+				change.barrierNeeded =
+					change.stateBefore != D3D12_RESOURCE_STATE_COMMON;
+			}
+
+			if (change.stateAfter != change.stateBefore)
+				changes.push_back(change);
+		}
+	}
+
+	bool barrierNeeded = uavBarrierNeeded;
+	for (const StateChange& change : changes)
+		barrierNeeded |= change.barrierNeeded;
+
+	if (initialTransitionPerformed == false)
+	{
+		if (barrierNeeded == false)
+		{
+			// Nothing has been transitioned yet, so promotions apply to the initial state
+			stateRuns.front().state |= newState;
+			return;
+		}
+
+		initialState = stateRuns.front().state;
+		initialTransitionPerformed = true;
+	}
+
+	for (const StateChange& change : changes)
+	{
+		if (change.barrierNeeded)
+		{
+			AddTransitionBarriers(change.keys, change.stateBefore,
+				change.stateAfter, barriers);
+		}
+	}
+
+	if (uavBarrierNeeded)
+	{
+		FrameResourceBarrier toAdd;
+		toAdd.InitializeAsUAV(identifier);
+		barriers.push_back(std::move(toAdd));
+	}
+
+	for (const StateChange& change : changes)
+		SetState(change.keys, change.stateAfter);
+
+	if (barrierNeeded)
+		lastBarrierMergeable = false;
+}
+
+FrameResource::FrameResource(const FrameResourceIdentifier& identifier) :
+	identifier(identifier)
+{
+	// EMPTY
+}
+
+bool FrameResource::UpdateState(D3D12_RESOURCE_STATES newState,
+	std::vector<FrameResourceBarrier>& barriers, const SubresourceRange& range)
+{
+	if (stateRuns.size() == 1 && range.CoversAll())
+		return UpdateWholeResourceState(newState, barriers);
+
+	UpdateSubresourceStates(newState, barriers, range);
+	return false;
+}
+
+void FrameResource::AddTransitionsToState(D3D12_RESOURCE_STATES newState,
+	std::vector<FrameResourceBarrier>& barriers) const
+{
+	for (size_t i = 0; i < stateRuns.size(); ++i)
+	{
+		if (stateRuns[i].state != newState)
+		{
+			AddTransitionBarriers({ stateRuns[i].startKey, GetRunEnd(i) },
+				stateRuns[i].state, newState, barriers);
+		}
+	}
 }
 
 D3D12_RESOURCE_STATES FrameResource::GetInitialState() const
 {
-	return initialTransitionPerformed == true ? initialState : currentState;
+	return initialTransitionPerformed == true ? initialState : stateRuns.front().state;
 }
 
 D3D12_RESOURCE_STATES FrameResource::GetCurrentState() const
 {
-	return currentState;
+	return stateRuns.front().state;
 }
 
 bool FrameResource::IsInWriteState() const
 {
-	return IsWriteState(currentState);
-}
+	for (const StateRun& run : stateRuns)
+	{
+		if (IsWriteState(run.state))
+			return true;
+	}
+
+	return false;
+}
\ No newline at end of file
@@ -1,21 +1,60 @@
 #pragma once
 
-#include <optional>
+#include <vector>
+#include <cstdint>
 
 #include <d3d12.h>
 
 #include "FrameResourceIdentifier.h"
 #include "FrameResourceBarrier.h"
+#include "ResourceIdentifiers.h"
 
 class FrameResource
 {
 private:
+	// States are run length encoded over the keys mip * MAX_ARRAY_SLICES + array slice
+	struct StateRun
+	{
+		std::uint32_t startKey = 0;
+		D3D12_RESOURCE_STATES state = D3D12_RESOURCE_STATE_COMMON;
+	};
+
+	struct KeyInterval
+	{
+		std::uint32_t startKey = 0;
+		std::uint32_t endKey = 0;
+	};
+
+	struct StateChange
+	{
+		KeyInterval keys;
+		D3D12_RESOURCE_STATES stateBefore = D3D12_RESOURCE_STATE_COMMON;
+		D3D12_RESOURCE_STATES stateAfter = D3D12_RESOURCE_STATE_COMMON;
+		bool barrierNeeded = false;
+	};
+
 	FrameResourceIdentifier identifier;
 	bool initialTransitionPerformed = false;
+	bool lastBarrierMergeable = false;
 	D3D12_RESOURCE_STATES initialState = D3D12_RESOURCE_STATE_COMMON;
-	D3D12_RESOURCE_STATES currentState = D3D12_RESOURCE_STATE_COMMON;
+	std::vector<StateRun> stateRuns = { StateRun() };
 
 	bool IsWriteState(D3D12_RESOURCE_STATES state) const;
+	bool TransitionRequired(D3D12_RESOURCE_STATES currentState,
+		D3D12_RESOURCE_STATES newState) const;
+
+	void GetKeyIntervals(const SubresourceRange& range,
+		std::vector<KeyInterval>& intervals) const;
+	std::uint32_t GetRunEnd(size_t runIndex) const;
+	void SetState(const KeyInterval& keys, D3D12_RESOURCE_STATES state);
+	void AddTransitionBarriers(const KeyInterval& keys,
+		D3D12_RESOURCE_STATES stateBefore, D3D12_RESOURCE_STATES stateAfter,
+		std::vector<FrameResourceBarrier>& barriers) const;
+
+	bool UpdateWholeResourceState(D3D12_RESOURCE_STATES newState,
+		std::vector<FrameResourceBarrier>& barriers);
+	void UpdateSubresourceStates(D3D12_RESOURCE_STATES newState,
+		std::vector<FrameResourceBarrier>& barriers, const SubresourceRange& range);
 
 public:
 	FrameResource(const FrameResourceIdentifier& identifier);
@@ -25,7 +64,12 @@ public:
 	FrameResource(FrameResource&& other) noexcept = default;
 	FrameResource& operator=(FrameResource&& other) noexcept = default;
 
-	std::optional<FrameResourceBarrier> UpdateState(D3D12_RESOURCE_STATES newState);
+	// Returns true if the request was compatible and can be merged into the last barrier
+	bool UpdateState(D3D12_RESOURCE_STATES newState,
+		std::vector<FrameResourceBarrier>& barriers,
+		const SubresourceRange& range = SubresourceRange());
+	void AddTransitionsToState(D3D12_RESOURCE_STATES newState,
+		std::vector<FrameResourceBarrier>& barriers) const;
 
 	D3D12_RESOURCE_STATES GetInitialState() const;
 	D3D12_RESOURCE_STATES GetCurrentState() const;
@@ -1,13 +1,94 @@
 #include "FrameResourceBarrier.h"
 
+#include <algorithm>
+
+namespace
+{
+	UINT GetPlaneCount(DXGI_FORMAT format)
+	{
+		switch (format)
+		{
+		case DXGI_FORMAT_R24G8_TYPELESS:
+		case DXGI_FORMAT_D24_UNORM_S8_UINT:
+		case DXGI_FORMAT_R24_UNORM_X8_TYPELESS:
+		case DXGI_FORMAT_X24_TYPELESS_G8_UINT:
+		case DXGI_FORMAT_R32G8X24_TYPELESS:
+		case DXGI_FORMAT_D32_FLOAT_S8X24_UINT:
+		case DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS:
+		case DXGI_FORMAT_X32_TYPELESS_G8X24_UINT:
+			return 2;
+		default:
+			return 1;
+		}
+	}
+}
+
+void FrameResourceBarrier::AddTransitionBarriers(
+	std::vector<D3D12_RESOURCE_BARRIER>& toAddTo, ID3D12Resource* resource,
+	D3D12_RESOURCE_STATES stateBefore, D3D12_RESOURCE_STATES stateAfter,
+	const SubresourceRange& range)
+{
+	D3D12_RESOURCE_BARRIER toAdd;
+	toAdd.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+	toAdd.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+	toAdd.Transition.pResource = resource;
+	toAdd.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+	toAdd.Transition.StateBefore = stateBefore;
+	toAdd.Transition.StateAfter = stateAfter;
+
+	if (range.CoversAll())
+	{
+		toAddTo.push_back(toAdd);
+		return;
+	}
+
+	D3D12_RESOURCE_DESC desc = resource->GetDesc();
+	if (desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER)
+	{
+		toAddTo.push_back(toAdd);
+		return;
+	}
+
+	UINT mipLevels = desc.MipLevels;
+	UINT arraySize = desc.Dimension == D3D12_RESOURCE_DIMENSION_TEXTURE3D ?
+		1 : desc.DepthOrArraySize;
+	UINT planeCount = GetPlaneCount(desc.Format);
+	UINT mipEnd = range.nrOfMips == SubresourceRange::ALL ? mipLevels :
+		std::min<UINT>(range.firstMip + range.nrOfMips, mipLevels);
+	UINT sliceEnd = range.nrOfArraySlices == SubresourceRange::ALL ? arraySize :
+		std::min<UINT>(range.firstArraySlice + range.nrOfArraySlices, arraySize);
+
+	if (range.firstMip == 0 && mipEnd == mipLevels &&
+		range.firstArraySlice == 0 && sliceEnd == arraySize)
+	{
+		toAddTo.push_back(toAdd);
+		return;
+	}
+
+	for (UINT plane = 0; plane < planeCount; ++plane)
+	{
+		for (UINT slice = range.firstArraySlice; slice < sliceEnd; ++slice)
+		{
+			for (UINT mip = range.firstMip; mip < mipEnd; ++mip)
+			{
+				toAdd.Transition.Subresource =
+					mip + slice * mipLevels + plane * mipLevels * arraySize;
+				toAddTo.push_back(toAdd);
+			}
+		}
+	}
+}
+
 void FrameResourceBarrier::InitializeAsTransition(
 	const FrameResourceIdentifier& identifier,
-	D3D12_RESOURCE_STATES stateBefore, D3D12_RESOURCE_STATES stateAfter)
+	D3D12_RESOURCE_STATES stateBefore, D3D12_RESOURCE_STATES stateAfter,
+	const SubresourceRange& range)
 {
 	type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
 	data.transition.identifier = identifier;
 	data.transition.stateBefore = stateBefore;
 	data.transition.stateAfter = stateAfter;
+	data.transition.range = range;
 }
 
 void FrameResourceBarrier::InitializeAsAliasing(
@@ -6,6 +6,7 @@
 #include <d3d12.h>
 
 #include "FrameResourceIdentifier.h"
+#include "ResourceIdentifiers.h"
 #include "FrameResourceContext.h"
 
 class FrameResourceBarrier
@@ -21,6 +22,7 @@ private:
 				FrameResourceIdentifier(TransientResourceIndex(-1));
 			D3D12_RESOURCE_STATES stateBefore;
 			D3D12_RESOURCE_STATES stateAfter;
+			SubresourceRange range;
 		} transition;
 
 		struct Aliasing
@@ -39,6 +41,10 @@ private:
 
 	} data;
 
+	static void AddTransitionBarriers(std::vector<D3D12_RESOURCE_BARRIER>& toAddTo,
+		ID3D12Resource* resource, D3D12_RESOURCE_STATES stateBefore,
+		D3D12_RESOURCE_STATES stateAfter, const SubresourceRange& range);
+
 	template<FrameType Frames>
 	void AddBarriersTransition(std::vector<D3D12_RESOURCE_BARRIER>& toAddTo,
 		FrameResourceContext<Frames>& context) const;
@@ -60,7 +66,8 @@ public:
 	FrameResourceBarrier& operator=(FrameResourceBarrier&& other) noexcept = default;
 
 	void InitializeAsTransition(const FrameResourceIdentifier& identifier,
-		D3D12_RESOURCE_STATES stateBefore, D3D12_RESOURCE_STATES stateAfter);
+		D3D12_RESOURCE_STATES stateBefore, D3D12_RESOURCE_STATES stateAfter,
+		const SubresourceRange& range = SubresourceRange());
 	void InitializeAsAliasing(const FrameResourceIdentifier& identifierBefore,
 		const FrameResourceIdentifier& identifierAfter);
 	void InitializeAsUAV(const FrameResourceIdentifier& identifier);
@@ -79,16 +86,17 @@ void FrameResourceBarrier::AddBarriersTransition(
 {
 	if (data.transition.identifier.origin == FrameResourceOrigin::TRANSIENT)
 	{
-		D3D12_RESOURCE_BARRIER toAdd;
-		toAdd.Type = type;
-		toAdd.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
 		auto handle = context.GetTransientResource(
 			data.transition.identifier.identifier.transient);
-		toAdd.Transition.pResource = handle.resource;
-		toAdd.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-		toAdd.Transition.StateBefore = data.transition.stateBefore;
-		toAdd.Transition.StateAfter = data.transition.stateAfter;
-		toAddTo.push_back(toAdd);
+		AddTransitionBarriers(toAddTo, handle.resource, data.transition.stateBefore,
+			data.transition.stateAfter, data.transition.range);
+	}
+	else if (data.transition.identifier.origin == FrameResourceOrigin::CATEGORY_RESOURCE)
+	{
+		auto handle = context.GetCategoryResource(
+			data.transition.identifier.identifier.categoryResource);
+		AddTransitionBarriers(toAddTo, handle.resource, data.transition.stateBefore,
+			data.transition.stateAfter, data.transition.range);
 	}
 	else
 	{
@@ -103,7 +111,7 @@ void FrameResourceBarrier::AddBarriersAliasing(
 	std::vector<D3D12_RESOURCE_BARRIER>& toAddTo,
 	FrameResourceContext<Frames>& context) const
 {
-	if (data.uav.identifier.origin == FrameResourceOrigin::CATEGORY)
+	if (data.uav.identifier.origin != FrameResourceOrigin::TRANSIENT)
 	{
 		throw std::runtime_error("Category aliasing barriers are not supported!");
 	}
@@ -135,6 +143,16 @@ void FrameResourceBarrier::AddBarriersUAV(
 		toAdd.UAV.pResource = handle.resource;
 		toAddTo.push_back(toAdd);
 	}
+	else if (data.uav.identifier.origin == FrameResourceOrigin::CATEGORY_RESOURCE)
+	{
+		D3D12_RESOURCE_BARRIER toAdd;
+		toAdd.Type = type;
+		toAdd.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+		auto handle = context.GetCategoryResource(
+			data.uav.identifier.identifier.categoryResource);
+		toAdd.UAV.pResource = handle.resource;
+		toAddTo.push_back(toAdd);
+	}
 	else
 	{
 		throw std::runtime_error("Category UAV barriers are not yet supported!");
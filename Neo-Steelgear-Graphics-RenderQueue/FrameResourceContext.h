@@ -41,6 +41,7 @@ public:
 	CategoryResourceHandle GetCategoryResource(const CategoryResourceIdentifier& identifier) const;
 	size_t GetCategoryDescriptorStart(const CategoryIdentifier& identifier, ViewType viewType) const;
 	size_t GetCategoryResourceDescriptor(const CategoryResourceIdentifier& identifier, ViewType viewType) const;
+	size_t GetBindlessResourceDescriptor(const CategoryResourceIdentifier& identifier, ViewType viewType) const;
 	size_t GetTransientDescriptorOffset(const ViewIdentifier& viewIdentifier) const;
 	D3D12_CPU_DESCRIPTOR_HANDLE GetTransientResourceRTV(const ViewIdentifier& viewIdentifier) const;
 	D3D12_CPU_DESCRIPTOR_HANDLE GetTransientResourceDSV(const ViewIdentifier& viewIdentifier) const;
@@ -111,6 +112,13 @@ inline size_t FrameResourceContext<Frames>::GetCategoryResourceDescriptor(
 	return toReturn;
 }
 
+template<FrameType Frames>
+inline size_t FrameResourceContext<Frames>::GetBindlessResourceDescriptor(
+	const CategoryResourceIdentifier& identifier, ViewType viewType) const
+{
+	return descriptorHeap->GetBindlessDescriptor(identifier, viewType);
+}
+
 template<FrameType Frames>
 size_t FrameResourceContext<Frames>::GetTransientDescriptorOffset(
 	const ViewIdentifier& viewIdentifier) const
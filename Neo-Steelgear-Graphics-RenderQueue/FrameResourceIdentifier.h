@@ -6,7 +6,8 @@
 enum class FrameResourceOrigin
 {
 	TRANSIENT,
-	CATEGORY
+	CATEGORY,
+	CATEGORY_RESOURCE
 };
 
 struct FrameResourceIdentifier
@@ -17,6 +18,7 @@ struct FrameResourceIdentifier
 	{
 		TransientResourceIndex transient;
 		CategoryIdentifier category;
+		CategoryResourceIdentifier categoryResource;
 
 		IdentifierData(const TransientResourceIndex& transientIndex) : 
 			transient(transientIndex)
@@ -30,6 +32,12 @@ struct FrameResourceIdentifier
 			// EMPTY
 		}
 
+		IdentifierData(const CategoryResourceIdentifier& categoryResourceIdentifier) :
+			categoryResource(categoryResourceIdentifier)
+		{
+			// EMPTY
+		}
+
 	} identifier;
 
 	FrameResourceIdentifier(const TransientResourceIndex& transientIndex) :
@@ -43,4 +51,11 @@ struct FrameResourceIdentifier
 	{
 		// EMPTY
 	}
+
+	FrameResourceIdentifier(const CategoryResourceIdentifier& categoryResourceIdentifier) :
+		origin(FrameResourceOrigin::CATEGORY_RESOURCE),
+		identifier(categoryResourceIdentifier)
+	{
+		// EMPTY
+	}
 };
\ No newline at end of file
@@ -2,6 +2,46 @@
 
 #include <stdexcept>
 
+size_t FrameSetupContext::ReserveLocalMemory(size_t size, size_t alignment)
+{
+	size_t currentTotal = totalLocalMemoryNeeded.load(std::memory_order_relaxed);
+	size_t startOffset = 0;
+
+	do
+	{
+		startOffset = ((currentTotal + (alignment - 1)) & ~(alignment - 1));
+	} while (!totalLocalMemoryNeeded.compare_exchange_weak(currentTotal,
+		startOffset + size, std::memory_order_relaxed));
+
+	return startOffset;
+}
+
+FrameSetupContext::FrameSetupContext(FrameSetupContext&& other) noexcept :
+	shaderBindableRequests(std::move(other.shaderBindableRequests)),
+	rtvRequests(std::move(other.rtvRequests)),
+	dsvRequests(std::move(other.dsvRequests)),
+	transientResourceDescs(std::move(other.transientResourceDescs)),
+	localResources(std::move(other.localResources)),
+	totalLocalMemoryNeeded(other.totalLocalMemoryNeeded.exchange(0))
+{
+	// EMPTY
+}
+
+FrameSetupContext& FrameSetupContext::operator=(FrameSetupContext&& other) noexcept
+{
+	if (this != &other)
+	{
+		shaderBindableRequests = std::move(other.shaderBindableRequests);
+		rtvRequests = std::move(other.rtvRequests);
+		dsvRequests = std::move(other.dsvRequests);
+		transientResourceDescs = std::move(other.transientResourceDescs);
+		localResources = std::move(other.localResources);
+		totalLocalMemoryNeeded = other.totalLocalMemoryNeeded.exchange(0);
+	}
+
+	return *this;
+}
+
 void FrameSetupContext::Reset(size_t nrOfTransientResources)
 {
 	shaderBindableRequests.clear();
@@ -13,7 +53,7 @@ void FrameSetupContext::Reset(size_t nrOfTransientResources)
 		transientResourceDescs.resize(nrOfTransientResources);
 	}
 
-	localResourceDescs.clear();
+	localResources.Clear();
 	totalLocalMemoryNeeded = 0;
 }
 
@@ -31,11 +71,29 @@ const TransientResourceDesc& FrameSetupContext::GetTransientResourceDesc(
 
 LocalResourceIndex FrameSetupContext::CreateLocalResource(const LocalResourceDesc& desc)
 {
-	size_t startOffset = ((totalLocalMemoryNeeded + 
-		(desc.GetAlignment() - 1)) & ~(desc.GetAlignment() - 1));
-	totalLocalMemoryNeeded = startOffset + desc.GetSize();
-	localResourceDescs.push_back(desc);
-	return localResourceDescs.size() - 1;
+	return CreateLocalResources(desc, 1);
+}
+
+LocalResourceIndex FrameSetupContext::CreateLocalResources(
+	const LocalResourceDesc& desc, size_t nrOfResources)
+{
+	if (nrOfResources == 0)
+		throw std::runtime_error("Cannot create zero local resources");
+
+	size_t alignment = desc.GetAlignment();
+	size_t alignedSize = ((desc.GetSize() + (alignment - 1)) & ~(alignment - 1));
+	size_t startOffset = ReserveLocalMemory(alignedSize * nrOfResources, alignment);
+	LocalResourceIndex firstIndex = localResources.ReserveRange(nrOfResources);
+
+	for (size_t i = 0; i < nrOfResources; ++i)
+	{
+		LocalResourcePlacement& placement = localResources[firstIndex + i];
+		placement.offset = startOffset + alignedSize * i;
+		placement.size = desc.GetSize();
+		placement.alignment = alignment;
+	}
+
+	return firstIndex;
 }
 
 ViewIdentifier FrameSetupContext::RequestTransientShaderBindable(
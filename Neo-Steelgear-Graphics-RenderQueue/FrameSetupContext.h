@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <optional>
+#include <atomic>
 
 #include <d3d12.h>
 
@@ -10,6 +11,7 @@
 
 #include "TransientResourceDesc.h"
 #include "LocalResourceDesc.h"
+#include "ConcurrentBlockVector.h"
 #include "Blackboard.h"
 #include "ResourceIdentifiers.h"
 
@@ -56,8 +58,10 @@ private:
 	std::vector<DescriptorRequest<std::optional<D3D12_DEPTH_STENCIL_VIEW_DESC>>> dsvRequests;
 
 	std::vector<TransientResourceDesc> transientResourceDescs;
-	std::vector<LocalResourceDesc> localResourceDescs;
-	size_t totalLocalMemoryNeeded = 0;
+	ConcurrentBlockVector<LocalResourcePlacement> localResources;
+	std::atomic<size_t> totalLocalMemoryNeeded = 0;
+
+	size_t ReserveLocalMemory(size_t size, size_t alignment);
 
 	template<FrameType Frames>
 	void CreateTransientDescriptors(Blackboard<Frames>& blackboard);
@@ -69,13 +73,15 @@ public:
 	~FrameSetupContext() = default;
 	FrameSetupContext(const FrameSetupContext& other) = delete;
 	FrameSetupContext& operator=(const FrameSetupContext& other) = delete;
-	FrameSetupContext(FrameSetupContext&& other) = default;
-	FrameSetupContext& operator=(FrameSetupContext&& other) = default;
+	FrameSetupContext(FrameSetupContext&& other) noexcept;
+	FrameSetupContext& operator=(FrameSetupContext&& other) noexcept;
 
 	void SetTransientResourceDesc(const TransientResourceIndex& index, const TransientResourceDesc& desc);
 	const TransientResourceDesc& GetTransientResourceDesc(const TransientResourceIndex& index);
 
 	LocalResourceIndex CreateLocalResource(const LocalResourceDesc& desc);
+	LocalResourceIndex CreateLocalResources(const LocalResourceDesc& desc,
+		size_t nrOfResources);
 
 	ViewIdentifier RequestTransientShaderBindable(const DescriptorRequest<ShaderBindableDescriptorDesc>& request);
 	ViewIdentifier RequestTransientRTV(const DescriptorRequest<std::optional<D3D12_RENDER_TARGET_VIEW_DESC>>& request);
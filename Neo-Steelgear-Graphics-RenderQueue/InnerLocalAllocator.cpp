@@ -2,6 +2,8 @@
 
 #include <stdexcept>
 
+#include "StreamingCopy.h"
+
 void InnerLocalAllocator::AllocateResource()
 {
 	D3D12_RESOURCE_DESC desc;
@@ -36,80 +38,313 @@ void InnerLocalAllocator::AllocateResource()
 	}
 }
 
-void InnerLocalAllocator::AllocateHeapChunk(size_t minimumSize)
+void InnerLocalAllocator::AllocateRing(size_t minimumSize)
 {
-	if (resource != nullptr)
-	{
-		resource->Release();
-		allocator->DeallocateChunk(heapChunk);
-	}
-
+	RetireRing();
 	heapChunk = allocator->AllocateChunk(minimumSize,
 		D3D12_HEAP_TYPE_UPLOAD, D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS);
 	currentSize = heapChunk.endOffset - heapChunk.startOffset;
 	AllocateResource();
+	activeRegions.clear(); // Regions of older frames live on in the retired ring
+	framesOversized = 0;
+	oversizedPeak = 0;
+}
+
+void InnerLocalAllocator::RetireRing()
+{
+	if (resource == nullptr)
+		return;
+
+	RetiredRing toRetire;
+	toRetire.heapChunk = heapChunk;
+	toRetire.resource = resource;
+	toRetire.framesLeft = framesInFlight;
+	retiredRings.push_back(toRetire);
+
+	resource = nullptr;
+	mappedPtr = nullptr;
+	currentSize = 0;
+}
+
+bool InnerLocalAllocator::TryPlaceRegion(size_t size, size_t& startOffset) const
+{
+	const size_t alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+
+	if (activeRegions.empty())
+	{
+		startOffset = 0;
+		return size <= currentSize;
+	}
+
+	size_t tail = activeRegions.front().startOffset;
+	size_t head = activeRegions.back().startOffset + activeRegions.back().size;
+	head = ((head + (alignment - 1)) & ~(alignment - 1));
+
+	if (activeRegions.back().startOffset < tail) // Already wrapped around
+	{
+		startOffset = head;
+		return head + size <= tail;
+	}
+
+	if (head + size <= currentSize)
+	{
+		startOffset = head;
+		return true;
+	}
+
+	startOffset = 0;
+	return size <= tail;
+}
+
+void InnerLocalAllocator::ShrinkRingIfOversized(size_t sizeNeeded)
+{
+	if (sizeNeeded * 4 <= currentSize && currentSize > memoryInfo.initialSize)
+	{
+		++framesOversized;
+		oversizedPeak = sizeNeeded > oversizedPeak ? sizeNeeded : oversizedPeak;
+	}
+	else
+	{
+		framesOversized = 0;
+		oversizedPeak = 0;
+	}
+
+	if (memoryInfo.framesBeforeShrinking != 0 &&
+		framesOversized >= memoryInfo.framesBeforeShrinking)
+	{
+		size_t newSize = oversizedPeak * 2 > memoryInfo.initialSize ?
+			oversizedPeak * 2 : memoryInfo.initialSize;
+		AllocateRing(newSize);
+	}
+}
+
+void InnerLocalAllocator::GrowRing(size_t sizeNeeded)
+{
+	size_t newSize = static_cast<size_t>(currentSize * memoryInfo.growthFactor);
+	newSize = currentSize + memoryInfo.expansionSize > newSize ?
+		currentSize + memoryInfo.expansionSize : newSize;
+	newSize = sizeNeeded > newSize ? sizeNeeded : newSize;
+	AllocateRing(newSize);
+}
+
+void InnerLocalAllocator::ReleaseRings()
+{
+	RetireRing();
+
+	for (auto& retiredRing : retiredRings)
+	{
+		retiredRing.resource->Release();
+		allocator->DeallocateChunk(retiredRing.heapChunk);
+	}
+
+	retiredRings.clear();
 }
 
 InnerLocalAllocator::~InnerLocalAllocator()
 {
-	if (resource != nullptr)
+	ReleaseRings();
+}
+
+InnerLocalAllocator::InnerLocalAllocator(InnerLocalAllocator&& other) noexcept :
+	device(other.device), memoryInfo(other.memoryInfo), allocator(other.allocator),
+	framesInFlight(other.framesInFlight), heapChunk(other.heapChunk),
+	resource(other.resource), currentSize(other.currentSize),
+	mappedPtr(other.mappedPtr), activeRegions(std::move(other.activeRegions)),
+	retiredRings(std::move(other.retiredRings)), currentRegion(other.currentRegion),
+	framesOversized(other.framesOversized), oversizedPeak(other.oversizedPeak),
+	buffers(std::move(other.buffers)), currentOffset(other.currentOffset.load())
+{
+	other.device = nullptr;
+	other.allocator = nullptr;
+	other.resource = nullptr;
+	other.currentSize = 0;
+	other.mappedPtr = nullptr;
+	other.currentRegion = FrameRegion();
+	other.currentOffset = 0;
+}
+
+InnerLocalAllocator& InnerLocalAllocator::operator=(InnerLocalAllocator&& other) noexcept
+{
+	if (this != &other)
 	{
-		resource->Release();
-		allocator->DeallocateChunk(heapChunk);
+		ReleaseRings();
+
+		device = other.device;
+		memoryInfo = other.memoryInfo;
+		allocator = other.allocator;
+		framesInFlight = other.framesInFlight;
+		heapChunk = other.heapChunk;
+		resource = other.resource;
+		currentSize = other.currentSize;
+		mappedPtr = other.mappedPtr;
+		activeRegions = std::move(other.activeRegions);
+		retiredRings = std::move(other.retiredRings);
+		currentRegion = other.currentRegion;
+		framesOversized = other.framesOversized;
+		oversizedPeak = other.oversizedPeak;
+		buffers = std::move(other.buffers);
+		currentOffset = other.currentOffset.load();
+
+		other.device = nullptr;
+		other.allocator = nullptr;
+		other.resource = nullptr;
+		other.currentSize = 0;
+		other.mappedPtr = nullptr;
+		other.currentRegion = FrameRegion();
+		other.currentOffset = 0;
 	}
+
+	return *this;
 }
 
 void InnerLocalAllocator::Initialize(ID3D12Device* deviceToUse,
 	const LocalAllocatorMemoryInfo& allocatorMemoryInfo,
-	HeapAllocatorGPU* allocatorToUse)
+	HeapAllocatorGPU* allocatorToUse, FrameType framesInFlightToUse)
 {
 	device = deviceToUse;
 	memoryInfo = allocatorMemoryInfo;
 	allocator = allocatorToUse;
-	AllocateHeapChunk(allocatorMemoryInfo.initialSize);
+	framesInFlight = framesInFlightToUse;
+	AllocateRing(allocatorMemoryInfo.initialSize);
 }
 
-void InnerLocalAllocator::Reset()
+void InnerLocalAllocator::SwapFrame()
 {
-	buffers.clear();
+	if (currentRegion.size != 0)
+	{
+		currentRegion.framesLeft = framesInFlight;
+		activeRegions.push_back(currentRegion);
+	}
+
+	currentRegion = FrameRegion();
+	buffers.Clear();
 	currentOffset = 0;
+
+	size_t nrToRelease = 0;
+	for (auto& region : activeRegions)
+	{
+		--region.framesLeft;
+		nrToRelease += region.framesLeft == 0 ? 1 : 0;
+	}
+
+	activeRegions.erase(activeRegions.begin(), activeRegions.begin() + nrToRelease);
+
+	for (size_t i = 0; i < retiredRings.size(); ++i)
+	{
+		--retiredRings[i].framesLeft;
+		if (retiredRings[i].framesLeft == 0)
+		{
+			retiredRings[i].resource->Release();
+			allocator->DeallocateChunk(retiredRings[i].heapChunk);
+			std::swap(retiredRings[i], retiredRings.back());
+			--i;
+			retiredRings.pop_back();
+		}
+	}
 }
 
 void InnerLocalAllocator::SetMinimumFrameDataSize(size_t minimumSizeNeeded)
 {
-	if (currentSize < minimumSizeNeeded)
+	const size_t alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+	size_t sizeNeeded = minimumSizeNeeded > GetUsedSize() ? minimumSizeNeeded : GetUsedSize();
+	size_t alignedSize = ((sizeNeeded + (alignment - 1)) & ~(alignment - 1));
+	ShrinkRingIfOversized(alignedSize * framesInFlight);
+
+	if (alignedSize == 0)
+		return;
+
+	size_t startOffset = 0;
+	if (!TryPlaceRegion(alignedSize, startOffset))
 	{
-		size_t newSize = currentSize + memoryInfo.expansionSize >= minimumSizeNeeded ?
-			currentSize + memoryInfo.expansionSize : minimumSizeNeeded;
-		AllocateHeapChunk(newSize);
+		GrowRing(alignedSize * framesInFlight);
+		TryPlaceRegion(alignedSize, startOffset);
 	}
+
+	currentRegion.startOffset = startOffset;
+	currentRegion.size = alignedSize;
 }
 
 LocalResourceIndex InnerLocalAllocator::AllocateBuffer(const LocalResourceDesc& desc)
 {
-	size_t startOffset = ((currentOffset + (desc.GetAlignment() - 1)) & ~(desc.GetAlignment() - 1));
-	currentOffset = startOffset + desc.GetSize();
-	BufferEntry toAdd = { startOffset, desc.GetSize() };
-	buffers.push_back(toAdd);
+	size_t oldOffset = currentOffset.load(std::memory_order_relaxed);
+	size_t startOffset = 0;
+
+	do
+	{
+		startOffset = ((oldOffset + (desc.GetAlignment() - 1)) & ~(desc.GetAlignment() - 1));
+
+		// Checked before claiming the range so a failed allocation does not consume memory
+		if (startOffset + desc.GetSize() > currentRegion.size)
+			throw std::runtime_error("Inner local allocator ran out of frame memory");
+	} while (!currentOffset.compare_exchange_weak(oldOffset,
+		startOffset + desc.GetSize(), std::memory_order_relaxed));
+
+	LocalResourceIndex toReturn = buffers.ReserveRange(1);
+	buffers[toReturn] = { startOffset, desc.GetSize(), desc.GetAlignment() };
+
+	return toReturn;
+}
+
+LocalResourceIndex InnerLocalAllocator::AllocateBuffer(
+	const LocalResourcePlacement& placement)
+{
+	size_t endOffset = placement.offset + placement.size;
+	size_t oldOffset = currentOffset.load(std::memory_order_relaxed);
+	while (oldOffset < endOffset && !currentOffset.compare_exchange_weak(
+		oldOffset, endOffset, std::memory_order_relaxed));
+
+	LocalResourceIndex toReturn = buffers.ReserveRange(1);
+	buffers[toReturn] = { placement.offset, placement.size, placement.alignment };
+
+	return toReturn;
+}
 
-	return buffers.size() - 1;
+void InnerLocalAllocator::RelocateBuffer(const LocalResourceIndex& index, size_t newOffset)
+{
+	buffers[index].offset = newOffset;
 }
 
 LocalResourceHandle InnerLocalAllocator::GetHandle(const LocalResourceIndex& index) const
 {
 	LocalResourceHandle toReturn;
 	toReturn.resource = resource;
-	toReturn.offset = buffers[index].offset;
+	toReturn.offset = buffers[index].offset == size_t(-1) ? size_t(-1) :
+		currentRegion.startOffset + buffers[index].offset;
 	toReturn.size = buffers[index].size;
 
 	return toReturn;
 }
 
+size_t InnerLocalAllocator::GetAlignment(const LocalResourceIndex& index) const
+{
+	return buffers[index].alignment;
+}
+
+size_t InnerLocalAllocator::GetNrOfBuffers() const
+{
+	return buffers.Size();
+}
+
 size_t InnerLocalAllocator::GetCurrentSize() const
 {
 	return currentSize;
 }
 
+size_t InnerLocalAllocator::GetFrameRegionOffset() const
+{
+	return currentRegion.startOffset;
+}
+
+size_t InnerLocalAllocator::GetFrameRegionSize() const
+{
+	return currentRegion.size;
+}
+
+size_t InnerLocalAllocator::GetUsedSize() const
+{
+	return currentOffset.load(std::memory_order_acquire);
+}
+
 D3D12_RESOURCE_BARRIER InnerLocalAllocator::GetInitializationBarrier()
 {
 	D3D12_RESOURCE_BARRIER toReturn;
@@ -123,5 +358,11 @@ D3D12_RESOURCE_BARRIER InnerLocalAllocator::GetInitializationBarrier()
 
 void InnerLocalAllocator::UpdateData(void* dataPtr, size_t dataSize)
 {
-	memcpy(mappedPtr, dataPtr, dataSize);
+	if (dataSize > currentRegion.size)
+		throw std::runtime_error("Local data does not fit in the current frame region");
+
+	if (dataSize != 0)
+		StreamingCopy(mappedPtr + currentRegion.startOffset, dataPtr, dataSize);
+
+	currentRegion.size = dataSize; // The unused tail can be given to the next frame
 }
\ No newline at end of file
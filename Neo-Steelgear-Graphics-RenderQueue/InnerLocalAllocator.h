@@ -4,11 +4,14 @@
 #include <dxgi.h>
 #include <vector>
 #include <utility>
+#include <atomic>
 
+#include <FrameBased.h>
 #include <HeapAllocatorGPU.h>
 
 #include "LocalResourceDesc.h"
 #include "ResourceIdentifiers.h"
+#include "ConcurrentBlockVector.h"
 
 struct LocalResourceHandle
 {
@@ -21,6 +24,9 @@ struct LocalAllocatorMemoryInfo
 {
 	size_t initialSize = 0;
 	size_t expansionSize = 0;
+	double growthFactor = 2.0;
+	size_t framesBeforeShrinking = 120;
+	bool deduplicateData = false;
 };
 
 class InnerLocalAllocator
@@ -31,20 +37,48 @@ private:
 	{
 		size_t offset = size_t(-1);
 		size_t size = 0;
+		size_t alignment = 1;
+	};
+
+	struct FrameRegion
+	{
+		size_t startOffset = 0;
+		size_t size = 0;
+		FrameType framesLeft = 0;
+	};
+
+	struct RetiredRing
+	{
+		HeapChunk heapChunk;
+		ID3D12Resource* resource = nullptr;
+		FrameType framesLeft = 0;
 	};
 
 	ID3D12Device* device = nullptr;
 	LocalAllocatorMemoryInfo memoryInfo;
 	HeapAllocatorGPU* allocator = nullptr;
+	FrameType framesInFlight = 1;
 	HeapChunk heapChunk;
 	ID3D12Resource* resource = nullptr;
-	std::vector<BufferEntry> buffers;
 	size_t currentSize = 0;
-	size_t currentOffset = 0;
 	unsigned char* mappedPtr = nullptr;
 
+	std::vector<FrameRegion> activeRegions;
+	std::vector<RetiredRing> retiredRings;
+	FrameRegion currentRegion;
+	size_t framesOversized = 0;
+	size_t oversizedPeak = 0;
+
+	ConcurrentBlockVector<BufferEntry> buffers;
+	std::atomic<size_t> currentOffset = 0;
+
 	void AllocateResource();
-	void AllocateHeapChunk(size_t minimumSize);
+	void AllocateRing(size_t minimumSize);
+	void RetireRing();
+	bool TryPlaceRegion(size_t size, size_t& startOffset) const;
+	void ShrinkRingIfOversized(size_t sizeNeeded);
+	void GrowRing(size_t sizeNeeded);
+	void ReleaseRings();
 
 public:
 	InnerLocalAllocator() = default;
@@ -56,15 +90,23 @@ public:
 
 	void Initialize(ID3D12Device* deviceToUse, 
 		const LocalAllocatorMemoryInfo& allocatorMemoryInfo,
-		HeapAllocatorGPU* allocatorToUse);
-	void Reset();
+		HeapAllocatorGPU* allocatorToUse, FrameType framesInFlightToUse);
+	void SwapFrame();
 
 	void SetMinimumFrameDataSize(size_t minimumSizeNeeded);
 
 	LocalResourceIndex AllocateBuffer(const LocalResourceDesc& desc);
+	LocalResourceIndex AllocateBuffer(const LocalResourcePlacement& placement);
+
+	void RelocateBuffer(const LocalResourceIndex& index, size_t newOffset);
 
 	LocalResourceHandle GetHandle(const LocalResourceIndex& index) const;
+	size_t GetAlignment(const LocalResourceIndex& index) const;
+	size_t GetNrOfBuffers() const;
 	size_t GetCurrentSize() const;
+	size_t GetFrameRegionOffset() const;
+	size_t GetFrameRegionSize() const;
+	size_t GetUsedSize() const;
 	D3D12_RESOURCE_BARRIER GetInitializationBarrier();
 
 	void UpdateData(void* dataPtr, size_t dataSize);
@@ -0,0 +1,241 @@
+#include "LocalDataDeduplicator.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+	constexpr std::uint64_t PRIME_1 = 0x9E3779B185EBCA87ull;
+	constexpr std::uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4Full;
+	constexpr std::uint64_t PRIME_3 = 0x165667B19E3779F9ull;
+	constexpr std::uint64_t PRIME_4 = 0x85EBCA77C2B2AE63ull;
+	constexpr size_t MINIMUM_NR_OF_SLOTS = 64;
+
+	constexpr std::uint64_t RETIRED_HASH = 2; // Data hashes are always odd
+	constexpr size_t PENDING_OFFSET = size_t(-1);
+	constexpr size_t FAILED_OFFSET = size_t(-2);
+	constexpr size_t LOCKED_REFERENCES = size_t(-1);
+
+	std::uint64_t RotateLeft(std::uint64_t value, int bits)
+	{
+		return (value << bits) | (value >> (64 - bits));
+	}
+}
+
+std::uint64_t LocalDataDeduplicator::HashData(const void* dataPtr, size_t size) const
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(dataPtr);
+	std::uint64_t hash = PRIME_3 ^ (size * PRIME_1);
+	size_t processed = 0;
+
+	for (; processed + 8 <= size; processed += 8)
+	{
+		std::uint64_t word = 0;
+		std::memcpy(&word, bytes + processed, 8);
+		hash ^= RotateLeft(word * PRIME_2, 31) * PRIME_1;
+		hash = RotateLeft(hash, 27) * PRIME_1 + PRIME_4;
+	}
+
+	for (; processed < size; ++processed)
+	{
+		hash ^= bytes[processed] * PRIME_3;
+		hash = RotateLeft(hash, 11) * PRIME_1;
+	}
+
+	hash ^= hash >> 33;
+	hash *= PRIME_2;
+	hash ^= hash >> 29;
+	hash *= PRIME_3;
+	hash ^= hash >> 32;
+
+	return hash | 1; // Zero marks an empty slot
+}
+
+size_t LocalDataDeduplicator::StoreData(const void* dataPtr, size_t size,
+	size_t alignment, unsigned char* stagingData, size_t stagingSize)
+{
+	size_t oldSize = usedSize.load(std::memory_order_relaxed);
+	size_t startOffset = 0;
+
+	do
+	{
+		startOffset = ((oldSize + (alignment - 1)) & ~(alignment - 1));
+
+		if (startOffset + size > stagingSize)
+			throw std::runtime_error("Deduplicated local data does not fit in the frame region");
+	} while (!usedSize.compare_exchange_weak(oldSize,
+		startOffset + size, std::memory_order_relaxed));
+
+	std::memcpy(stagingData + startOffset, dataPtr, size);
+	return startOffset;
+}
+
+bool LocalDataDeduplicator::AddReference(Slot& slot)
+{
+	size_t references = slot.references.load(std::memory_order_acquire);
+
+	do
+	{
+		// Unreferenced slots failed to store, locked ones are being overwritten by their owner
+		if (references == 0 || references == LOCKED_REFERENCES)
+			return false;
+	} while (!slot.references.compare_exchange_weak(references, references + 1,
+		std::memory_order_acq_rel));
+
+	return true;
+}
+
+LocalDataDeduplicator::LocalDataDeduplicator(LocalDataDeduplicator&& other) noexcept :
+	slots(std::move(other.slots)), nrOfSlots(other.nrOfSlots),
+	usedSize(other.usedSize.exchange(0))
+{
+	other.nrOfSlots = 0;
+}
+
+LocalDataDeduplicator& LocalDataDeduplicator::operator=(
+	LocalDataDeduplicator&& other) noexcept
+{
+	if (this != &other)
+	{
+		slots = std::move(other.slots);
+		nrOfSlots = other.nrOfSlots;
+		other.nrOfSlots = 0;
+		usedSize = other.usedSize.exchange(0);
+	}
+
+	return *this;
+}
+
+void LocalDataDeduplicator::Reset(size_t expectedNrOfPayloads)
+{
+	size_t slotsNeeded = MINIMUM_NR_OF_SLOTS;
+	while (slotsNeeded < expectedNrOfPayloads * 2)
+		slotsNeeded *= 2;
+
+	if (slotsNeeded > nrOfSlots)
+	{
+		slots = std::make_unique<Slot[]>(slotsNeeded);
+		nrOfSlots = slotsNeeded;
+	}
+	else
+	{
+		for (size_t i = 0; i < nrOfSlots; ++i)
+		{
+			slots[i].hash.store(0, std::memory_order_relaxed);
+			slots[i].offset.store(PENDING_OFFSET, std::memory_order_relaxed);
+			slots[i].references.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	usedSize = 0;
+}
+
+size_t LocalDataDeduplicator::Deduplicate(const void* dataPtr, size_t size,
+	size_t alignment, unsigned char* stagingData, size_t stagingSize, size_t& slotIndexOut)
+{
+	std::uint64_t hash = HashData(dataPtr, size);
+	size_t mask = nrOfSlots - 1;
+	size_t slotIndex = static_cast<size_t>(hash) & mask;
+
+	for (size_t probes = 0; probes < nrOfSlots; ++probes)
+	{
+		Slot& slot = slots[slotIndex];
+		std::uint64_t storedHash = 0;
+
+		if (slot.hash.compare_exchange_strong(storedHash, hash, std::memory_order_acq_rel))
+		{
+			size_t offset = FAILED_OFFSET;
+
+			try
+			{
+				offset = StoreData(dataPtr, size, alignment, stagingData, stagingSize);
+			}
+			catch (...)
+			{
+				// Threads waiting on this slot must not wait for data that never arrives
+				slot.offset.store(FAILED_OFFSET, std::memory_order_release);
+				throw;
+			}
+
+			slot.size.store(size, std::memory_order_relaxed);
+			slot.alignment.store(alignment, std::memory_order_relaxed);
+			slot.references.store(1, std::memory_order_relaxed);
+			slot.offset.store(offset, std::memory_order_release);
+			slotIndexOut = slotIndex;
+			return offset;
+		}
+
+		if (storedHash == hash)
+		{
+			size_t offset = slot.offset.load(std::memory_order_acquire);
+			while (offset == PENDING_OFFSET) // The owner is still copying its data
+			{
+				std::this_thread::yield();
+				offset = slot.offset.load(std::memory_order_acquire);
+			}
+
+			// Matching the alignment keeps the packed size within the reserved slack
+			if (offset != FAILED_OFFSET && slot.size.load(std::memory_order_relaxed) == size &&
+				slot.alignment.load(std::memory_order_relaxed) == alignment &&
+				AddReference(slot))
+			{
+				if (std::memcmp(stagingData + offset, dataPtr, size) == 0)
+				{
+					slotIndexOut = slotIndex;
+					return offset;
+				}
+
+				slot.references.fetch_sub(1, std::memory_order_acq_rel);
+			}
+		}
+
+		slotIndex = (slotIndex + 1) & mask;
+	}
+
+	slotIndexOut = size_t(-1);
+	return StoreData(dataPtr, size, alignment, stagingData, stagingSize);
+}
+
+size_t LocalDataDeduplicator::Replace(const void* dataPtr, size_t size,
+	size_t alignment, unsigned char* stagingData, size_t stagingSize,
+	size_t currentOffset, size_t& slotIndex)
+{
+	if (slotIndex == size_t(-1)) // Stored outside the table, nothing else refers to it
+	{
+		std::memcpy(stagingData + currentOffset, dataPtr, size);
+		return currentOffset;
+	}
+
+	Slot& slot = slots[slotIndex];
+	size_t references = slot.references.load(std::memory_order_acquire);
+
+	while (references != 1)
+	{
+		// Shared with other payloads, which keep the old data
+		if (slot.references.compare_exchange_weak(references, references - 1,
+			std::memory_order_acq_rel))
+		{
+			return Deduplicate(dataPtr, size, alignment, stagingData, stagingSize, slotIndex);
+		}
+	}
+
+	if (!slot.references.compare_exchange_strong(references, LOCKED_REFERENCES,
+		std::memory_order_acq_rel))
+	{
+		// Another payload started sharing the data in the meantime
+		return Replace(dataPtr, size, alignment, stagingData, stagingSize,
+			currentOffset, slotIndex);
+	}
+
+	// Sole user of the data, overwrite it in place and stop others matching the old hash
+	slot.hash.store(RETIRED_HASH, std::memory_order_release);
+	std::memcpy(stagingData + currentOffset, dataPtr, size);
+	slot.references.store(1, std::memory_order_release);
+	return currentOffset;
+}
+
+size_t LocalDataDeduplicator::GetUsedSize() const
+{
+	return usedSize.load(std::memory_order_acquire);
+}
\ No newline at end of file
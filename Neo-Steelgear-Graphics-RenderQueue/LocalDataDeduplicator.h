@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+class LocalDataDeduplicator
+{
+private:
+	struct Slot
+	{
+		std::atomic<std::uint64_t> hash = 0;
+		std::atomic<size_t> size = 0;
+		std::atomic<size_t> alignment = 0;
+		std::atomic<size_t> offset = size_t(-1);
+		std::atomic<size_t> references = 0;
+	};
+
+	std::unique_ptr<Slot[]> slots;
+	size_t nrOfSlots = 0;
+	std::atomic<size_t> usedSize = 0;
+
+	std::uint64_t HashData(const void* dataPtr, size_t size) const;
+	bool AddReference(Slot& slot);
+	size_t StoreData(const void* dataPtr, size_t size, size_t alignment,
+		unsigned char* stagingData, size_t stagingSize);
+
+public:
+	LocalDataDeduplicator() = default;
+	~LocalDataDeduplicator() = default;
+	LocalDataDeduplicator(const LocalDataDeduplicator& other) = delete;
+	LocalDataDeduplicator& operator=(const LocalDataDeduplicator& other) = delete;
+	LocalDataDeduplicator(LocalDataDeduplicator&& other) noexcept;
+	LocalDataDeduplicator& operator=(LocalDataDeduplicator&& other) noexcept;
+
+	void Reset(size_t expectedNrOfPayloads);
+
+	// Returns the offset of the data and the slot now referencing it, or size_t(-1) if it
+	// was stored outside the table and is never shared
+	size_t Deduplicate(const void* dataPtr, size_t size, size_t alignment,
+		unsigned char* stagingData, size_t stagingSize, size_t& slotIndex);
+
+	// Sets new data for a payload that was already deduplicated into slotIndex at currentOffset
+	size_t Replace(const void* dataPtr, size_t size, size_t alignment,
+		unsigned char* stagingData, size_t stagingSize, size_t currentOffset,
+		size_t& slotIndex);
+
+	size_t GetUsedSize() const;
+};
\ No newline at end of file
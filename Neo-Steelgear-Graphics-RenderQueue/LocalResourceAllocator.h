@@ -1,29 +1,41 @@
 #pragma once
 
-#include <FrameObject.h>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include <FrameBased.h>
 
 #include "InnerLocalAllocator.h"
+#include "LocalDataDeduplicator.h"
 
 template<FrameType Frames>
 class LocalResourceAllocator : FrameBased<Frames>
 {
 private:
-	FrameObject<InnerLocalAllocator, Frames> allocators;
+	InnerLocalAllocator allocator;
 	std::vector<unsigned char> data;
+	bool deduplicateData = false;
+	LocalDataDeduplicator deduplicator;
+	std::vector<size_t> deduplicationSlots;
+	std::atomic<size_t> alignmentSlack = 0;
+
+	LocalResourceIndex PrepareForDeduplication(const LocalResourceIndex& index);
 
 public:
 	LocalResourceAllocator() = default;
 	~LocalResourceAllocator() = default;
 	LocalResourceAllocator(const LocalResourceAllocator& other) = delete;
 	LocalResourceAllocator& operator=(const LocalResourceAllocator& other) = delete;
-	LocalResourceAllocator(LocalResourceAllocator&& other) noexcept = default;
-	LocalResourceAllocator& operator=(LocalResourceAllocator&& other) noexcept = default;
+	LocalResourceAllocator(LocalResourceAllocator&& other) noexcept;
+	LocalResourceAllocator& operator=(LocalResourceAllocator&& other) noexcept;
 
 	void Initialize(ID3D12Device* deviceToUse, const LocalAllocatorMemoryInfo& memoryInfo,
 		HeapAllocatorGPU* allocatorToUse);
 	void SetMinimumFrameDataSize(size_t minimumSizeNeeded);
 
 	LocalResourceIndex CreateLocalResource(const LocalResourceDesc& desc);
+	LocalResourceIndex CreateLocalResource(const LocalResourcePlacement& placement);
 	void SetLocalResourceData(const LocalResourceIndex& index, const void* dataPtr);
 
 	LocalResourceHandle GetLocalResourceHandle(const LocalResourceIndex& index) const;
@@ -34,60 +46,149 @@ public:
 	void SwapFrame() override;
 };
 
+template<FrameType Frames>
+LocalResourceIndex LocalResourceAllocator<Frames>::PrepareForDeduplication(
+	const LocalResourceIndex& index)
+{
+	if (deduplicateData)
+	{
+		// Duplicates are resolved once data is set, the final offset is unknown until then
+		alignmentSlack += allocator.GetAlignment(index) - 1;
+		allocator.RelocateBuffer(index, size_t(-1));
+	}
+
+	return index;
+}
+
+template<FrameType Frames>
+LocalResourceAllocator<Frames>::LocalResourceAllocator(
+	LocalResourceAllocator&& other) noexcept : allocator(std::move(other.allocator)),
+	data(std::move(other.data)), deduplicateData(other.deduplicateData),
+	deduplicator(std::move(other.deduplicator)),
+	deduplicationSlots(std::move(other.deduplicationSlots)),
+	alignmentSlack(other.alignmentSlack.exchange(0))
+{
+	// EMPTY
+}
+
+template<FrameType Frames>
+LocalResourceAllocator<Frames>& LocalResourceAllocator<Frames>::operator=(
+	LocalResourceAllocator&& other) noexcept
+{
+	if (this != &other)
+	{
+		allocator = std::move(other.allocator);
+		data = std::move(other.data);
+		deduplicateData = other.deduplicateData;
+		deduplicator = std::move(other.deduplicator);
+		deduplicationSlots = std::move(other.deduplicationSlots);
+		alignmentSlack = other.alignmentSlack.exchange(0);
+	}
+
+	return *this;
+}
+
 template<FrameType Frames>
 void LocalResourceAllocator<Frames>::Initialize(ID3D12Device* deviceToUse,
 	const LocalAllocatorMemoryInfo& memoryInfo, HeapAllocatorGPU* allocatorToUse)
 {
-	allocators.Initialize< InnerLocalAllocator, ID3D12Device*,
-		const LocalAllocatorMemoryInfo&, HeapAllocatorGPU*>(
-			&InnerLocalAllocator::Initialize, deviceToUse, memoryInfo, allocatorToUse);
-	data.resize(allocators.Active().GetCurrentSize());
+	allocator.Initialize(deviceToUse, memoryInfo, allocatorToUse, Frames);
+	deduplicateData = memoryInfo.deduplicateData;
 }
 
 template<FrameType Frames>
 void LocalResourceAllocator<Frames>::SetMinimumFrameDataSize(size_t minimumSizeNeeded)
 {
-	allocators.Active().SetMinimumFrameDataSize(minimumSizeNeeded);
-	data.resize(allocators.Active().GetCurrentSize());
+	if (deduplicateData)
+	{
+		// Packing unique data in the order it is set can need extra padding
+		allocator.SetMinimumFrameDataSize(minimumSizeNeeded + alignmentSlack);
+		deduplicator.Reset(allocator.GetNrOfBuffers());
+		deduplicationSlots.assign(allocator.GetNrOfBuffers(), size_t(-1));
+	}
+	else
+	{
+		allocator.SetMinimumFrameDataSize(minimumSizeNeeded);
+	}
+
+	data.resize(allocator.GetFrameRegionSize());
 }
 
 template<FrameType Frames>
 LocalResourceIndex LocalResourceAllocator<Frames>::CreateLocalResource(
 	const LocalResourceDesc& desc)
 {
-	return allocators.Active().AllocateBuffer(desc);
+	return PrepareForDeduplication(allocator.AllocateBuffer(desc));
+}
+
+template<FrameType Frames>
+LocalResourceIndex LocalResourceAllocator<Frames>::CreateLocalResource(
+	const LocalResourcePlacement& placement)
+{
+	return PrepareForDeduplication(allocator.AllocateBuffer(placement));
 }
 
 template<FrameType Frames>
 void LocalResourceAllocator<Frames>::SetLocalResourceData(
 	const LocalResourceIndex& index, const void* dataPtr)
 {
-	LocalResourceHandle handle = allocators.Active().GetHandle(index);
-	memcpy(&data[handle.offset], dataPtr, handle.size);
+	LocalResourceHandle handle = allocator.GetHandle(index);
+
+	if (deduplicateData)
+	{
+		size_t offset = 0;
+
+		if (handle.offset == size_t(-1))
+		{
+			offset = deduplicator.Deduplicate(dataPtr, handle.size,
+				allocator.GetAlignment(index), data.data(), data.size(),
+				deduplicationSlots[index]);
+		}
+		else // Setting the data again replaces it, as without deduplication
+		{
+			offset = deduplicator.Replace(dataPtr, handle.size,
+				allocator.GetAlignment(index), data.data(), data.size(),
+				handle.offset - allocator.GetFrameRegionOffset(),
+				deduplicationSlots[index]);
+		}
+
+		allocator.RelocateBuffer(index, offset);
+		return;
+	}
+
+	size_t localOffset = handle.offset - allocator.GetFrameRegionOffset();
+	memcpy(&data[localOffset], dataPtr, handle.size);
 }
 
 template<FrameType Frames>
 LocalResourceHandle LocalResourceAllocator<Frames>::GetLocalResourceHandle(
 	const LocalResourceIndex& index) const
 {
-	return allocators.Active().GetHandle(index);
+	LocalResourceHandle toReturn = allocator.GetHandle(index);
+
+	if (toReturn.offset == size_t(-1))
+		throw std::runtime_error("Deduplicated local resource used before its data was set");
+
+	return toReturn;
 }
 
 template<FrameType Frames>
 D3D12_RESOURCE_BARRIER LocalResourceAllocator<Frames>::GetInitializationBarrier()
 {
-	return allocators.Active().GetInitializationBarrier();
+	return allocator.GetInitializationBarrier();
 }
 
 template<FrameType Frames>
 void LocalResourceAllocator<Frames>::UploadData()
 {
-	allocators.Active().UpdateData(data.data(), data.size());
+	size_t usedSize = deduplicateData ? deduplicator.GetUsedSize() : allocator.GetUsedSize();
+	allocator.UpdateData(data.data(), usedSize);
 }
 
 template<FrameType Frames>
 void LocalResourceAllocator<Frames>::SwapFrame()
 {
-	allocators.SwapFrame();
-	allocators.Active().Reset();
+	FrameBased<Frames>::SwapFrame();
+	allocator.SwapFrame();
+	alignmentSlack = 0;
 }
\ No newline at end of file
@@ -1,5 +1,11 @@
 #pragma once
 
+struct LocalResourcePlacement
+{
+	size_t offset = size_t(-1);
+	size_t size = 0;
+	size_t alignment = 1;
+};
 
 class LocalResourceDesc
 {
@@ -61,6 +61,15 @@ void ManagedCommandAllocator::ExecuteCommands(ID3D12CommandQueue* queue)
 	firstUnexecuted = currentList;
 }
 
+void ManagedCommandAllocator::GatherCommandsForExecution(
+	std::vector<ID3D12CommandList*>& toExecute)
+{
+	for (unsigned int i = firstUnexecuted; i < currentList; ++i)
+		toExecute.push_back(commandLists[i]);
+
+	firstUnexecuted = currentList;
+}
+
 void ManagedCommandAllocator::Reset()
 {
 	HRESULT hr = allocator->Reset();
@@ -26,6 +26,7 @@ public:
 	ID3D12GraphicsCommandList* ActiveList();
 	void FinishActiveList(bool prepareNewList = false);
 	void ExecuteCommands(ID3D12CommandQueue* queue);
+	void GatherCommandsForExecution(std::vector<ID3D12CommandList*>& toExecute);
 	void Reset();
 
 	size_t GetNrOfStoredLists();
@@ -3,6 +3,9 @@
 #include <unordered_map>
 #include <stdexcept>
 #include <vector>
+#include <array>
+#include <cstdint>
+#include <algorithm>
 
 #include <d3d12.h>
 
@@ -12,10 +15,50 @@
 
 #include "CategoryIdentifiers.h"
 
+constexpr std::uint64_t ALWAYS_DIRTY_DESCRIPTORS = std::uint64_t(-1);
+
+struct DescriptorHeapSizingInfo
+{
+	size_t usageWindowSize = 120;
+	double usageHeadroom = 1.25;
+	size_t framesBeforeShrinking = 300;
+};
+
+struct DescriptorHeapStatistics
+{
+	size_t descriptorsPerFrame = 0;
+	size_t lastFrameUsage = 0;
+	size_t peakWindowUsage = 0;
+	size_t persistentCapacity = 0;
+	size_t persistentUsed = 0;
+	size_t bindlessCapacity = 0;
+	size_t bindlessUsed = 0;
+	size_t midFrameGrowths = 0;
+	size_t predictedGrowths = 0;
+	size_t shrinks = 0;
+	size_t lastFrameCopyCalls = 0;
+	size_t lastFrameDescriptorsCopied = 0;
+};
+
 template<FrameType Frames>
 class ManagedDescriptorHeap : public FrameBased<Frames>
 {
 private:
+	struct DescriptorSegment
+	{
+		SIZE_T sourcePtr = 0;
+		UINT nrOfDescriptors = 0;
+		size_t heapOffset = 0;
+		std::uint64_t version = ALWAYS_DIRTY_DESCRIPTORS;
+
+		bool Matches(const DescriptorSegment& other) const
+		{
+			return version != ALWAYS_DIRTY_DESCRIPTORS && version == other.version &&
+				sourcePtr == other.sourcePtr && nrOfDescriptors == other.nrOfDescriptors &&
+				heapOffset == other.heapOffset;
+		}
+	};
+
 	struct ComponentOffset
 	{
 		size_t cbvOffset = size_t(-1);
@@ -23,9 +66,78 @@ private:
 		size_t uavOffset = size_t(-1);
 	};
 
-	std::unordered_map<CategoryIdentifier, ComponentOffset> componentOffsets;
+	struct PersistentRange
+	{
+		size_t offset = size_t(-1);
+		UINT nrOfDescriptors = 0;
+		SIZE_T sourcePtr = 0;
+		std::uint64_t version = ALWAYS_DIRTY_DESCRIPTORS;
+	};
+
+	struct PersistentCategory
+	{
+		PersistentRange cbv;
+		PersistentRange srv;
+		PersistentRange uav;
+	};
+
+	struct FreePersistentRange
+	{
+		size_t offset = 0;
+		size_t size = 0;
+	};
+
+	struct RetiredPersistentRange
+	{
+		FreePersistentRange range;
+		FrameType framesLeft = Frames;
+	};
+
+	struct BindlessIndices
+	{
+		size_t cbvIndex = size_t(-1);
+		size_t srvIndex = size_t(-1);
+		size_t uavIndex = size_t(-1);
+	};
+
+	struct RetiredBindlessIndex
+	{
+		size_t index = size_t(-1);
+		FrameType framesLeft = Frames;
+	};
+
+	struct PendingBindlessDescriptor
+	{
+		CategoryResourceIdentifier identifier;
+		ViewType viewType = ViewType::SRV;
+		size_t bindlessIndex = size_t(-1);
+	};
+
+	struct DescriptorCopyBatch
+	{
+		std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> destinationStarts;
+		std::vector<UINT> destinationSizes;
+		std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> sourceStarts;
+		std::vector<UINT> sourceSizes;
+		UINT nrOfDescriptors = 0;
+	};
+
+	std::vector<ComponentOffset> componentOffsets; // Indexed by dense category index
 	size_t globalDescriptorsOffset = 0;
 
+	std::vector<PersistentCategory> persistentCategories; // Indexed by dense category index
+	std::vector<FreePersistentRange> freePersistentRanges;
+	std::vector<RetiredPersistentRange> retiredPersistentRanges;
+	size_t persistentCapacity = 0;
+	size_t persistentEnd = 0;
+
+	std::unordered_map<CategoryResourceIdentifier, BindlessIndices> bindlessResources;
+	std::vector<size_t> freeBindlessIndices;
+	std::vector<RetiredBindlessIndex> retiredBindlessIndices;
+	std::vector<PendingBindlessDescriptor> pendingBindlessDescriptors;
+	size_t bindlessCapacity = 0;
+	size_t bindlessEnd = 0;
+
 	ID3D12Device* device = nullptr;
 	D3DPtr<ID3D12DescriptorHeap> cpuHeap;
 	D3DPtr<ID3D12DescriptorHeap> gpuHeap;
@@ -33,11 +145,45 @@ private:
 	size_t currentOffset = 0;
 	unsigned int descriptorSize = 0;
 
+	std::vector<DescriptorSegment> currentSegments;
+	std::vector<DescriptorSegment> cpuHeapSegments;
+	std::array<std::vector<DescriptorSegment>, Frames> uploadedSegments;
+
+	DescriptorHeapSizingInfo sizingInfo;
+	unsigned int minimumDescriptorsPerFrame = 0;
+	std::vector<size_t> usageWindow;
+	size_t usageWindowPosition = 0;
+	size_t framesUnderused = 0;
+	DescriptorHeapStatistics statistics;
+
+	DescriptorCopyBatch copyBatch;
+	bool mirrorWritesQueued = false;
+	size_t copyCalls = 0;
+	size_t descriptorsCopied = 0;
+
 	void ThrowIfFailed(HRESULT hr, const std::exception& exception);
 
 	void CreateDescriptorHeaps(unsigned int nrOfDescriptors);
+	void RecreateDescriptorHeaps(size_t newBindlessCapacity,
+		size_t newPersistentCapacity, unsigned int newDescriptorsPerFrame);
 	void StoreDescriptors(D3D12_CPU_DESCRIPTOR_HANDLE sourceHandle,
-		UINT nrOfComponents);
+		UINT nrOfComponents, std::uint64_t version);
+	void QueueCopy(D3D12_CPU_DESCRIPTOR_HANDLE destination,
+		D3D12_CPU_DESCRIPTOR_HANDLE source, UINT nrOfDescriptors);
+	void QueueShaderVisibleCopy(const DescriptorSegment& segment);
+	void ResizeForPredictedUsage();
+
+	size_t AllocatePersistentRange(size_t nrOfDescriptors);
+	void ReleasePersistentRange(const FreePersistentRange& range);
+	void StorePersistentDescriptors(PersistentRange& range,
+		D3D12_CPU_DESCRIPTOR_HANDLE sourceHandle, UINT nrOfComponents,
+		std::uint64_t version);
+	void AddPersistentCategoryDescriptors(const CategoryIdentifier& identifier,
+		const ResourceComponent& component, std::uint64_t descriptorVersion);
+
+	size_t AllocateBindlessIndex();
+	size_t AddPendingBindlessDescriptor(const CategoryResourceIdentifier& identifier,
+		ViewType viewType);
 
 	struct ReplacedDescriptorHeap
 	{
@@ -56,10 +202,13 @@ public:
 	ManagedDescriptorHeap& operator=(ManagedDescriptorHeap&& other) noexcept = default;
 
 	void Initialize(ID3D12Device* deviceToUse,
-		unsigned int startDescriptorsPerFrame);
+		unsigned int startDescriptorsPerFrame,
+		unsigned int startPersistentDescriptors = 0,
+		unsigned int startBindlessDescriptors = 0,
+		const DescriptorHeapSizingInfo& sizingInfoToUse = DescriptorHeapSizingInfo());
 
 	void AddCategoryDescriptors(const CategoryIdentifier& identifier,
-		const ResourceComponent& component);
+		const ResourceComponent& component, std::uint64_t descriptorVersion);
 	size_t GetCategoryHeapOffset(const CategoryIdentifier& identifier,
 		ViewType viewType) const;
 
@@ -67,8 +216,20 @@ public:
 		size_t nrOfDescriptors);
 	size_t GetGlobalOffset() const;
 
+	void FlushQueuedCopies();
+
+	void AddBindlessResource(const CategoryResourceIdentifier& identifier,
+		const ResourceComponent& component);
+	void RemoveBindlessResource(const CategoryResourceIdentifier& identifier);
+	// Sources are looked up when written, as a category may move its descriptors when it grows
+	template<typename CategoryLookup>
+	void StorePendingBindlessDescriptors(CategoryLookup&& getCategory);
+	size_t GetBindlessDescriptor(const CategoryResourceIdentifier& identifier,
+		ViewType viewType) const;
+
 	void UploadCurrentFrameHeap();
 	ID3D12DescriptorHeap* GetShaderVisibleHeap() const;
+	DescriptorHeapStatistics GetStatistics() const;
 
 	void SwapFrame() override;
 };
@@ -85,48 +246,399 @@ template<FrameType Frames>
 inline void ManagedDescriptorHeap<Frames>::CreateDescriptorHeaps(
 	unsigned int nrOfDescriptors)
 {
+	// Both heaps start with the bindless and persistent regions, followed by the frame region(s)
+	size_t sharedDescriptors = bindlessCapacity + persistentCapacity;
 	D3D12_DESCRIPTOR_HEAP_DESC desc;
 	desc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-	desc.NumDescriptors = nrOfDescriptors;
+	desc.NumDescriptors = static_cast<UINT>(sharedDescriptors + nrOfDescriptors);
 	desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
 	desc.NodeMask = 0;
 	HRESULT hr = device->CreateDescriptorHeap(&desc, IID_PPV_ARGS(&cpuHeap));
 	ThrowIfFailed(hr, std::runtime_error("Failed to create cpu descriptor heap"));
 
 	desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-	desc.NumDescriptors = nrOfDescriptors * Frames;
+	desc.NumDescriptors = static_cast<UINT>(sharedDescriptors + nrOfDescriptors * Frames);
 	hr = device->CreateDescriptorHeap(&desc, IID_PPV_ARGS(&gpuHeap));
 	ThrowIfFailed(hr, std::runtime_error("Failed to create gpu descriptor heap"));
 }
 
+template<FrameType Frames>
+inline void ManagedDescriptorHeap<Frames>::RecreateDescriptorHeaps(
+	size_t newBindlessCapacity, size_t newPersistentCapacity,
+	unsigned int newDescriptorsPerFrame)
+{
+	FlushQueuedCopies(); // Queued copies target the old heaps
+
+	D3DPtr<ID3D12DescriptorHeap> temp = std::move(cpuHeap); // We need to copy already stored descriptors
+	replacedDescriptors.push_back({ std::move(gpuHeap), Frames }); // Store for deletion when safe
+	size_t oldBindlessCapacity = bindlessCapacity;
+	size_t oldPersistentCapacity = persistentCapacity;
+	bindlessCapacity = newBindlessCapacity;
+	persistentCapacity = newPersistentCapacity;
+	descriptorsPerFrame = newDescriptorsPerFrame;
+	CreateDescriptorHeaps(descriptorsPerFrame);
+
+	// Everything is copied from the old cpu heap, so all copies can share one batch
+	auto oldStart = temp->GetCPUDescriptorHandleForHeapStart();
+	auto newStart = cpuHeap->GetCPUDescriptorHandleForHeapStart();
+	auto newShaderVisibleStart = gpuHeap->GetCPUDescriptorHandleForHeapStart();
+
+	// Bindless indices must stay stable, so that region is copied as is
+	if (bindlessEnd != 0)
+	{
+		QueueCopy(newStart, oldStart, static_cast<UINT>(bindlessEnd));
+		QueueCopy(newShaderVisibleStart, oldStart, static_cast<UINT>(bindlessEnd));
+	}
+
+	// Retired ranges can only be in use by the old heap, so the live ranges are packed
+	freePersistentRanges.clear();
+	retiredPersistentRanges.clear();
+	persistentEnd = 0;
+	for (auto& category : persistentCategories)
+	{
+		for (PersistentRange* range : { &category.cbv, &category.srv, &category.uav })
+		{
+			if (range->offset == size_t(-1))
+				continue;
+
+			auto source = oldStart;
+			source.ptr += (oldBindlessCapacity + range->offset) * descriptorSize;
+			size_t destinationOffset = (bindlessCapacity + persistentEnd) * descriptorSize;
+			auto destination = newStart;
+			destination.ptr += destinationOffset;
+			auto shaderVisibleDestination = newShaderVisibleStart;
+			shaderVisibleDestination.ptr += destinationOffset;
+			QueueCopy(destination, source, range->nrOfDescriptors);
+			QueueCopy(shaderVisibleDestination, source, range->nrOfDescriptors);
+			range->offset = persistentEnd;
+			persistentEnd += range->nrOfDescriptors;
+		}
+	}
+
+	if (currentOffset != 0)
+	{
+		auto source = oldStart;
+		source.ptr += (oldBindlessCapacity + oldPersistentCapacity) * descriptorSize;
+		auto destination = newStart;
+		destination.ptr += (bindlessCapacity + persistentCapacity) * descriptorSize;
+		QueueCopy(destination, source, static_cast<UINT>(currentOffset));
+	}
+
+	FlushQueuedCopies(); // Must happen before the old cpu heap is released
+
+	cpuHeapSegments = currentSegments; // Only what was stored this frame was carried over
+	for (auto& segments : uploadedSegments)
+		segments.clear();
+}
+
 template<FrameType Frames>
 inline void ManagedDescriptorHeap<Frames>::StoreDescriptors(
-	D3D12_CPU_DESCRIPTOR_HANDLE sourceHandle, UINT nrOfComponents)
+	D3D12_CPU_DESCRIPTOR_HANDLE sourceHandle, UINT nrOfComponents,
+	std::uint64_t version)
 {
 	if (descriptorsPerFrame - currentOffset < nrOfComponents)
 	{
-		D3DPtr<ID3D12DescriptorHeap> temp = std::move(cpuHeap); // We need to copy already stored descriptors
-		replacedDescriptors.push_back({ std::move(gpuHeap), Frames }); // Store for deletion when safe
-		descriptorsPerFrame *= 2;
-		CreateDescriptorHeaps(descriptorsPerFrame);
-		device->CopyDescriptorsSimple(currentOffset, cpuHeap->GetCPUDescriptorHandleForHeapStart(),
-			temp->GetCPUDescriptorHandleForHeapStart(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+		// Doubled from at least one descriptor, a heap created with zero would never grow
+		size_t newDescriptorsPerFrame = std::max<size_t>(descriptorsPerFrame, 1);
+		while (newDescriptorsPerFrame - currentOffset < nrOfComponents)
+			newDescriptorsPerFrame *= 2;
+
+		if (newDescriptorsPerFrame > UINT(-1))
+			throw std::runtime_error("Descriptors needed for frame exceed what a descriptor heap can hold");
+
+		RecreateDescriptorHeaps(bindlessCapacity, persistentCapacity,
+			static_cast<unsigned int>(newDescriptorsPerFrame));
+		++statistics.midFrameGrowths;
+	}
+
+	DescriptorSegment segment;
+	segment.sourcePtr = sourceHandle.ptr;
+	segment.nrOfDescriptors = nrOfComponents;
+	segment.heapOffset = currentOffset;
+	segment.version = version;
+	size_t segmentIndex = currentSegments.size();
+
+	if (segmentIndex >= cpuHeapSegments.size() ||
+		!segment.Matches(cpuHeapSegments[segmentIndex]))
+	{
+		auto destinationHandle = cpuHeap->GetCPUDescriptorHandleForHeapStart();
+		destinationHandle.ptr += (bindlessCapacity + persistentCapacity + currentOffset) *
+			descriptorSize;
+		QueueCopy(destinationHandle, sourceHandle, nrOfComponents);
+		mirrorWritesQueued |= version != ALWAYS_DIRTY_DESCRIPTORS;
 	}
 
-	auto destinationHandle = cpuHeap->GetCPUDescriptorHandleForHeapStart();
-	destinationHandle.ptr += currentOffset * descriptorSize;
-	device->CopyDescriptorsSimple(nrOfComponents, destinationHandle,
-		sourceHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+	currentSegments.push_back(segment);
 	currentOffset += nrOfComponents;
 }
 
+template<FrameType Frames>
+inline void ManagedDescriptorHeap<Frames>::QueueCopy(
+	D3D12_CPU_DESCRIPTOR_HANDLE destination, D3D12_CPU_DESCRIPTOR_HANDLE source,
+	UINT nrOfDescriptors)
+{
+	// Source and destination ranges only need matching totals, so each side merges separately
+	auto& batch = copyBatch;
+	if (!batch.destinationStarts.empty() && batch.destinationStarts.back().ptr +
+		batch.destinationSizes.back() * descriptorSize == destination.ptr)
+	{
+		batch.destinationSizes.back() += nrOfDescriptors;
+	}
+	else
+	{
+		batch.destinationStarts.push_back(destination);
+		batch.destinationSizes.push_back(nrOfDescriptors);
+	}
+
+	if (!batch.sourceStarts.empty() && batch.sourceStarts.back().ptr +
+		batch.sourceSizes.back() * descriptorSize == source.ptr)
+	{
+		batch.sourceSizes.back() += nrOfDescriptors;
+	}
+	else
+	{
+		batch.sourceStarts.push_back(source);
+		batch.sourceSizes.push_back(nrOfDescriptors);
+	}
+
+	batch.nrOfDescriptors += nrOfDescriptors;
+}
+
+template<FrameType Frames>
+inline void ManagedDescriptorHeap<Frames>::QueueShaderVisibleCopy(
+	const DescriptorSegment& segment)
+{
+	size_t sharedDescriptors = bindlessCapacity + persistentCapacity;
+	auto destination = gpuHeap->GetCPUDescriptorHandleForHeapStart();
+	destination.ptr += (sharedDescriptors + this->activeFrame * descriptorsPerFrame +
+		segment.heapOffset) * descriptorSize;
+
+	// Segments that are always dirty have their cpu copy in the same batch,
+	// so they are read from their original source instead
+	D3D12_CPU_DESCRIPTOR_HANDLE source;
+	if (segment.version == ALWAYS_DIRTY_DESCRIPTORS)
+	{
+		source.ptr = segment.sourcePtr;
+	}
+	else
+	{
+		source = cpuHeap->GetCPUDescriptorHandleForHeapStart();
+		source.ptr += (sharedDescriptors + segment.heapOffset) * descriptorSize;
+	}
+
+	QueueCopy(destination, source, segment.nrOfDescriptors);
+}
+
+template<FrameType Frames>
+inline void ManagedDescriptorHeap<Frames>::ResizeForPredictedUsage()
+{
+	size_t peakUsage = *std::max_element(usageWindow.begin(), usageWindow.end());
+	size_t targetSize = static_cast<size_t>(peakUsage * sizingInfo.usageHeadroom);
+	targetSize = std::max<size_t>(targetSize, minimumDescriptorsPerFrame);
+
+	if (targetSize > descriptorsPerFrame)
+	{
+		framesUnderused = 0;
+		RecreateDescriptorHeaps(bindlessCapacity, persistentCapacity,
+			static_cast<unsigned int>(std::max<size_t>(targetSize, descriptorsPerFrame * 2)));
+		++statistics.predictedGrowths;
+	}
+	else if (targetSize * 4 <= descriptorsPerFrame)
+	{
+		if (++framesUnderused < sizingInfo.framesBeforeShrinking)
+			return;
+
+		framesUnderused = 0;
+		RecreateDescriptorHeaps(bindlessCapacity, persistentCapacity,
+			static_cast<unsigned int>(std::max<size_t>(targetSize * 2, minimumDescriptorsPerFrame)));
+		++statistics.shrinks;
+	}
+	else
+	{
+		framesUnderused = 0;
+	}
+}
+
+template<FrameType Frames>
+inline size_t ManagedDescriptorHeap<Frames>::AllocatePersistentRange(
+	size_t nrOfDescriptors)
+{
+	for (size_t i = 0; i < freePersistentRanges.size(); ++i)
+	{
+		FreePersistentRange& freeRange = freePersistentRanges[i];
+		if (freeRange.size < nrOfDescriptors)
+			continue;
+
+		size_t toReturn = freeRange.offset;
+		freeRange.offset += nrOfDescriptors;
+		freeRange.size -= nrOfDescriptors;
+		if (freeRange.size == 0)
+			freePersistentRanges.erase(freePersistentRanges.begin() + i);
+
+		return toReturn;
+	}
+
+	if (persistentCapacity - persistentEnd < nrOfDescriptors)
+		return size_t(-1);
+
+	size_t toReturn = persistentEnd;
+	persistentEnd += nrOfDescriptors;
+	return toReturn;
+}
+
+template<FrameType Frames>
+inline void ManagedDescriptorHeap<Frames>::ReleasePersistentRange(
+	const FreePersistentRange& range)
+{
+	auto position = std::lower_bound(freePersistentRanges.begin(),
+		freePersistentRanges.end(), range.offset,
+		[](const FreePersistentRange& element, size_t offset)
+		{
+			return element.offset < offset;
+		});
+	position = freePersistentRanges.insert(position, range);
+
+	auto next = position + 1;
+	if (next != freePersistentRanges.end() &&
+		position->offset + position->size == next->offset)
+	{
+		position->size += next->size;
+		freePersistentRanges.erase(next);
+	}
+
+	if (position != freePersistentRanges.begin())
+	{
+		auto previous = position - 1;
+		if (previous->offset + previous->size == position->offset)
+		{
+			previous->size += position->size;
+			freePersistentRanges.erase(position);
+		}
+	}
+}
+
+template<FrameType Frames>
+inline void ManagedDescriptorHeap<Frames>::StorePersistentDescriptors(
+	PersistentRange& range, D3D12_CPU_DESCRIPTOR_HANDLE sourceHandle,
+	UINT nrOfComponents, std::uint64_t version)
+{
+	if (range.offset != size_t(-1) && range.version == version &&
+		range.sourcePtr == sourceHandle.ptr && range.nrOfDescriptors == nrOfComponents)
+	{
+		return;
+	}
+
+	// Frames in flight may still read the old range, so changes are written to a new one
+	if (range.offset != size_t(-1))
+	{
+		retiredPersistentRanges.push_back({ { range.offset, range.nrOfDescriptors }, Frames });
+		range.offset = size_t(-1);
+	}
+
+	size_t offset = AllocatePersistentRange(nrOfComponents);
+	if (offset == size_t(-1))
+	{
+		size_t liveDescriptors = nrOfComponents;
+		for (auto& category : persistentCategories)
+		{
+			for (PersistentRange* liveRange : { &category.cbv, &category.srv, &category.uav })
+			{
+				if (liveRange->offset != size_t(-1))
+					liveDescriptors += liveRange->nrOfDescriptors;
+			}
+		}
+
+		RecreateDescriptorHeaps(bindlessCapacity,
+			std::max<size_t>(persistentCapacity * 2, liveDescriptors * 2), descriptorsPerFrame);
+		offset = AllocatePersistentRange(nrOfComponents);
+	}
+
+	auto destination = cpuHeap->GetCPUDescriptorHandleForHeapStart();
+	destination.ptr += (bindlessCapacity + offset) * descriptorSize;
+	QueueCopy(destination, sourceHandle, nrOfComponents);
+	auto shaderVisibleDestination = gpuHeap->GetCPUDescriptorHandleForHeapStart();
+	shaderVisibleDestination.ptr += (bindlessCapacity + offset) * descriptorSize;
+	QueueCopy(shaderVisibleDestination, sourceHandle, nrOfComponents);
+
+	range.offset = offset;
+	range.nrOfDescriptors = nrOfComponents;
+	range.sourcePtr = sourceHandle.ptr;
+	range.version = version;
+}
+
+template<FrameType Frames>
+inline void ManagedDescriptorHeap<Frames>::AddPersistentCategoryDescriptors(
+	const CategoryIdentifier& identifier, const ResourceComponent& component,
+	std::uint64_t descriptorVersion)
+{
+	if (persistentCategories.size() <= identifier.denseIndex)
+		persistentCategories.resize(identifier.denseIndex + 1);
+
+	PersistentCategory& category = persistentCategories[identifier.denseIndex];
+	UINT nrOfComponents = static_cast<UINT>(component.NrOfDescriptors());
+
+	if (component.HasDescriptorsOfType(ViewType::CBV))
+	{
+		StorePersistentDescriptors(category.cbv, component.GetDescriptorHeapCBV(),
+			nrOfComponents, descriptorVersion);
+	}
+
+	if (component.HasDescriptorsOfType(ViewType::SRV))
+	{
+		StorePersistentDescriptors(category.srv, component.GetDescriptorHeapSRV(),
+			nrOfComponents, descriptorVersion);
+	}
+
+	if (component.HasDescriptorsOfType(ViewType::UAV))
+	{
+		StorePersistentDescriptors(category.uav, component.GetDescriptorHeapUAV(),
+			nrOfComponents, descriptorVersion);
+	}
+}
+
+template<FrameType Frames>
+inline size_t ManagedDescriptorHeap<Frames>::AllocateBindlessIndex()
+{
+	if (!freeBindlessIndices.empty())
+	{
+		size_t toReturn = freeBindlessIndices.back();
+		freeBindlessIndices.pop_back();
+		return toReturn;
+	}
+
+	if (bindlessEnd == bindlessCapacity)
+	{
+		RecreateDescriptorHeaps(std::max<size_t>(bindlessCapacity * 2, 1024),
+			persistentCapacity, descriptorsPerFrame);
+	}
+
+	return bindlessEnd++;
+}
+
+template<FrameType Frames>
+inline size_t ManagedDescriptorHeap<Frames>::AddPendingBindlessDescriptor(
+	const CategoryResourceIdentifier& identifier, ViewType viewType)
+{
+	size_t toReturn = AllocateBindlessIndex();
+	pendingBindlessDescriptors.push_back({ identifier, viewType, toReturn });
+
+	return toReturn;
+}
+
 template<FrameType Frames>
 inline void ManagedDescriptorHeap<Frames>::Initialize(
-	ID3D12Device* deviceToUse, unsigned int startDescriptorsPerFrame)
+	ID3D12Device* deviceToUse, unsigned int startDescriptorsPerFrame,
+	unsigned int startPersistentDescriptors, unsigned int startBindlessDescriptors,
+	const DescriptorHeapSizingInfo& sizingInfoToUse)
 {
 	replacedDescriptors.reserve(5); // Should stop unnecessary dynamic expansions during reasonable runtime operations
 	device = deviceToUse;
 	descriptorsPerFrame = startDescriptorsPerFrame;
+	minimumDescriptorsPerFrame = startDescriptorsPerFrame;
+	sizingInfo = sizingInfoToUse;
+	usageWindow.resize(std::max<size_t>(sizingInfo.usageWindowSize, 1), 0);
+	persistentCapacity = startPersistentDescriptors;
+	bindlessCapacity = startBindlessDescriptors;
 	descriptorSize = device->GetDescriptorHandleIncrementSize(
 		D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
 	CreateDescriptorHeaps(startDescriptorsPerFrame);
@@ -134,75 +646,271 @@ inline void ManagedDescriptorHeap<Frames>::Initialize(
 
 template<FrameType Frames>
 inline void ManagedDescriptorHeap<Frames>::AddCategoryDescriptors(
-	const CategoryIdentifier& identifier, const ResourceComponent& component)
+	const CategoryIdentifier& identifier, const ResourceComponent& component,
+	std::uint64_t descriptorVersion)
 {
+	if (!identifier.dynamicCategory)
+	{
+		AddPersistentCategoryDescriptors(identifier, component, descriptorVersion);
+		return;
+	}
+
 	ComponentOffset toStore;
 	UINT nrOfComponents = static_cast<UINT>(component.NrOfDescriptors());
-	size_t heapStartCurrentFrame = descriptorsPerFrame * this->activeFrame;
 
 	if (component.HasDescriptorsOfType(ViewType::CBV))
 	{
-		toStore.cbvOffset = currentOffset + heapStartCurrentFrame;
-		StoreDescriptors(component.GetDescriptorHeapCBV(), nrOfComponents);
+		toStore.cbvOffset = currentOffset;
+		StoreDescriptors(component.GetDescriptorHeapCBV(), nrOfComponents, descriptorVersion);
 	}
 
 	if (component.HasDescriptorsOfType(ViewType::SRV))
 	{
-		toStore.srvOffset = currentOffset + heapStartCurrentFrame;
-		StoreDescriptors(component.GetDescriptorHeapSRV(), nrOfComponents);
+		toStore.srvOffset = currentOffset;
+		StoreDescriptors(component.GetDescriptorHeapSRV(), nrOfComponents, descriptorVersion);
 	}
 
 	if (component.HasDescriptorsOfType(ViewType::UAV))
 	{
-		toStore.uavOffset = currentOffset + heapStartCurrentFrame;
-		StoreDescriptors(component.GetDescriptorHeapUAV(), nrOfComponents);
+		toStore.uavOffset = currentOffset;
+		StoreDescriptors(component.GetDescriptorHeapUAV(), nrOfComponents, descriptorVersion);
 	}
 
-	componentOffsets[identifier] = toStore;
+	if (componentOffsets.size() <= identifier.denseIndex)
+		componentOffsets.resize(identifier.denseIndex + 1);
+
+	componentOffsets[identifier.denseIndex] = toStore;
 }
 
 template<FrameType Frames>
 inline size_t ManagedDescriptorHeap<Frames>::GetCategoryHeapOffset(
 	const CategoryIdentifier& identifier, ViewType viewType) const
 {
-	const auto& offsets = componentOffsets.at(identifier);
+	size_t offset = size_t(-1);
+	size_t regionStart = 0;
 
-	switch (viewType)
+	if (!identifier.dynamicCategory)
 	{
-	case ViewType::CBV:
-		return offsets.cbvOffset;
-	case ViewType::SRV:
-		return offsets.srvOffset;
-	case ViewType::UAV:
-		return offsets.uavOffset;
-	default:
-		throw std::runtime_error("Attempting to get heap offset of incorrect type");
+		if (persistentCategories.size() <= identifier.denseIndex)
+			throw std::runtime_error("Attempting to get heap offset of category without stored descriptors");
+
+		const auto& category = persistentCategories[identifier.denseIndex];
+		regionStart = bindlessCapacity;
+
+		switch (viewType)
+		{
+		case ViewType::CBV:
+			offset = category.cbv.offset;
+			break;
+		case ViewType::SRV:
+			offset = category.srv.offset;
+			break;
+		case ViewType::UAV:
+			offset = category.uav.offset;
+			break;
+		default:
+			throw std::runtime_error("Attempting to get heap offset of incorrect type");
+		}
 	}
+	else
+	{
+		if (componentOffsets.size() <= identifier.denseIndex)
+			throw std::runtime_error("Attempting to get heap offset of category without stored descriptors");
+
+		const auto& offsets = componentOffsets[identifier.denseIndex];
+		regionStart = bindlessCapacity + persistentCapacity +
+			descriptorsPerFrame * this->activeFrame;
+
+		switch (viewType)
+		{
+		case ViewType::CBV:
+			offset = offsets.cbvOffset;
+			break;
+		case ViewType::SRV:
+			offset = offsets.srvOffset;
+			break;
+		case ViewType::UAV:
+			offset = offsets.uavOffset;
+			break;
+		default:
+			throw std::runtime_error("Attempting to get heap offset of incorrect type");
+		}
+	}
+
+	// Unset offsets are size_t(-1) and would wrap around to a valid looking offset
+	if (offset == size_t(-1))
+		throw std::runtime_error("Attempting to get heap offset of view type not stored for category");
+
+	return regionStart + offset;
 }
 
 template<FrameType Frames>
 inline void ManagedDescriptorHeap<Frames>::AddGlobalDescriptors(
 	D3D12_CPU_DESCRIPTOR_HANDLE startHandle, size_t nrOfDescriptors)
 {
-	size_t heapStartCurrentFrame = descriptorsPerFrame * this->activeFrame;
-	globalDescriptorsOffset = currentOffset + heapStartCurrentFrame;
-	StoreDescriptors(startHandle, nrOfDescriptors);
+	globalDescriptorsOffset = currentOffset;
+	StoreDescriptors(startHandle, static_cast<UINT>(nrOfDescriptors),
+		ALWAYS_DIRTY_DESCRIPTORS); // Transient descriptors are recreated every frame
 }
 
 template<FrameType Frames>
 inline size_t ManagedDescriptorHeap<Frames>::GetGlobalOffset() const
 {
-	return globalDescriptorsOffset;
+	return bindlessCapacity + persistentCapacity + globalDescriptorsOffset +
+		descriptorsPerFrame * this->activeFrame;
+}
+
+template<FrameType Frames>
+inline void ManagedDescriptorHeap<Frames>::AddBindlessResource(
+	const CategoryResourceIdentifier& identifier, const ResourceComponent& component)
+{
+	BindlessIndices toStore;
+
+	if (component.HasDescriptorsOfType(ViewType::CBV))
+		toStore.cbvIndex = AddPendingBindlessDescriptor(identifier, ViewType::CBV);
+
+	if (component.HasDescriptorsOfType(ViewType::SRV))
+		toStore.srvIndex = AddPendingBindlessDescriptor(identifier, ViewType::SRV);
+
+	if (component.HasDescriptorsOfType(ViewType::UAV))
+		toStore.uavIndex = AddPendingBindlessDescriptor(identifier, ViewType::UAV);
+
+	bindlessResources[identifier] = toStore;
+}
+
+template<FrameType Frames>
+inline void ManagedDescriptorHeap<Frames>::RemoveBindlessResource(
+	const CategoryResourceIdentifier& identifier)
+{
+	auto iterator = bindlessResources.find(identifier);
+	if (iterator == bindlessResources.end())
+		return;
+
+	std::erase_if(pendingBindlessDescriptors,
+		[&identifier](const PendingBindlessDescriptor& pending)
+		{
+			return pending.identifier == identifier;
+		});
+
+	// Frames in flight may still index the descriptors, so they are recycled later
+	const BindlessIndices& indices = iterator->second;
+	for (size_t index : { indices.cbvIndex, indices.srvIndex, indices.uavIndex })
+	{
+		if (index != size_t(-1))
+			retiredBindlessIndices.push_back({ index, Frames });
+	}
+
+	bindlessResources.erase(iterator);
+}
+
+template<FrameType Frames>
+template<typename CategoryLookup>
+inline void ManagedDescriptorHeap<Frames>::StorePendingBindlessDescriptors(
+	CategoryLookup&& getCategory)
+{
+	if (pendingBindlessDescriptors.empty())
+		return;
+
+	auto getSource = [&](const PendingBindlessDescriptor& pending)
+	{
+		const ResourceComponent& component =
+			getCategory(pending.identifier.categoryIdentifier);
+		D3D12_CPU_DESCRIPTOR_HANDLE source;
+
+		switch (pending.viewType)
+		{
+		case ViewType::CBV:
+			source = component.GetDescriptorHeapCBV();
+			break;
+		case ViewType::SRV:
+			source = component.GetDescriptorHeapSRV();
+			break;
+		case ViewType::UAV:
+			source = component.GetDescriptorHeapUAV();
+			break;
+		default:
+			throw std::runtime_error("Attempting to store bindless descriptor of incorrect type");
+		}
+
+		source.ptr += pending.identifier.internalIndex.descriptorIndex * descriptorSize;
+		return source;
+	};
+
+	// One pass per heap, indices are mostly handed out in order so each pass merges into few ranges
+	for (ID3D12DescriptorHeap* heap : { cpuHeap.Get(), gpuHeap.Get() })
+	{
+		auto heapStart = heap->GetCPUDescriptorHandleForHeapStart();
+
+		for (const PendingBindlessDescriptor& pending : pendingBindlessDescriptors)
+		{
+			auto destination = heapStart;
+			destination.ptr += pending.bindlessIndex * descriptorSize;
+			QueueCopy(destination, getSource(pending), 1);
+		}
+	}
+
+	pendingBindlessDescriptors.clear();
+	FlushQueuedCopies();
+}
+
+template<FrameType Frames>
+inline size_t ManagedDescriptorHeap<Frames>::GetBindlessDescriptor(
+	const CategoryResourceIdentifier& identifier, ViewType viewType) const
+{
+	const auto& indices = bindlessResources.at(identifier);
+
+	switch (viewType)
+	{
+	case ViewType::CBV:
+		return indices.cbvIndex;
+	case ViewType::SRV:
+		return indices.srvIndex;
+	case ViewType::UAV:
+		return indices.uavIndex;
+	default:
+		throw std::runtime_error("Attempting to get bindless descriptor of incorrect type");
+	}
+}
+
+template<FrameType Frames>
+inline void ManagedDescriptorHeap<Frames>::FlushQueuedCopies()
+{
+	auto& batch = copyBatch;
+	if (batch.nrOfDescriptors == 0)
+		return;
+
+	device->CopyDescriptors(static_cast<UINT>(batch.destinationStarts.size()),
+		batch.destinationStarts.data(), batch.destinationSizes.data(),
+		static_cast<UINT>(batch.sourceStarts.size()), batch.sourceStarts.data(),
+		batch.sourceSizes.data(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+	++copyCalls;
+	descriptorsCopied += batch.nrOfDescriptors;
+
+	batch.destinationStarts.clear();
+	batch.destinationSizes.clear();
+	batch.sourceStarts.clear();
+	batch.sourceSizes.clear();
+	batch.nrOfDescriptors = 0;
+	mirrorWritesQueued = false;
 }
 
 template<FrameType Frames>
 inline void ManagedDescriptorHeap<Frames>::UploadCurrentFrameHeap()
 {
-	auto destination = gpuHeap->GetCPUDescriptorHandleForHeapStart();
-	destination.ptr += this->activeFrame * descriptorsPerFrame * descriptorSize;
-	auto source = cpuHeap->GetCPUDescriptorHandleForHeapStart();
-	device->CopyDescriptorsSimple(descriptorsPerFrame, destination, source,
-		D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+	auto& previousSegments = uploadedSegments[this->activeFrame];
+	if (mirrorWritesQueued)
+		FlushQueuedCopies(); // Those writes are the source of the shader visible copies
+
+	for (size_t i = 0; i < currentSegments.size(); ++i)
+	{
+		const DescriptorSegment& segment = currentSegments[i];
+		if (i >= previousSegments.size() || !segment.Matches(previousSegments[i]))
+			QueueShaderVisibleCopy(segment);
+	}
+
+	FlushQueuedCopies();
+	previousSegments = currentSegments;
+	cpuHeapSegments = currentSegments;
 }
 
 template<FrameType Frames>
@@ -212,21 +920,73 @@ ManagedDescriptorHeap<Frames>::GetShaderVisibleHeap() const
 	return gpuHeap;
 }
 
+template<FrameType Frames>
+inline DescriptorHeapStatistics ManagedDescriptorHeap<Frames>::GetStatistics() const
+{
+	DescriptorHeapStatistics toReturn = statistics;
+	toReturn.descriptorsPerFrame = descriptorsPerFrame;
+	toReturn.peakWindowUsage = *std::max_element(usageWindow.begin(), usageWindow.end());
+	toReturn.persistentCapacity = persistentCapacity;
+	toReturn.persistentUsed = persistentEnd;
+	for (const auto& freeRange : freePersistentRanges)
+		toReturn.persistentUsed -= freeRange.size;
+	toReturn.bindlessCapacity = bindlessCapacity;
+	toReturn.bindlessUsed = bindlessEnd - freeBindlessIndices.size();
+
+	return toReturn;
+}
+
 template<FrameType Frames>
 inline void ManagedDescriptorHeap<Frames>::SwapFrame()
 {
 	FrameBased<Frames>::SwapFrame();
+	statistics.lastFrameUsage = currentOffset;
+	statistics.lastFrameCopyCalls = copyCalls;
+	statistics.lastFrameDescriptorsCopied = descriptorsCopied;
+	copyCalls = 0;
+	descriptorsCopied = 0;
+	usageWindow[usageWindowPosition] = currentOffset;
+	usageWindowPosition = (usageWindowPosition + 1) % usageWindow.size();
 	currentOffset = 0;
 	globalDescriptorsOffset = 0;
+	currentSegments.clear();
+
+	for (size_t i = 0; i < retiredPersistentRanges.size(); ++i)
+	{
+		--retiredPersistentRanges[i].framesLeft;
+		if (retiredPersistentRanges[i].framesLeft == 0)
+		{
+			ReleasePersistentRange(retiredPersistentRanges[i].range);
+			std::swap(retiredPersistentRanges[i], retiredPersistentRanges.back());
+			--i;
+			retiredPersistentRanges.pop_back();
+		}
+	}
+
+	for (size_t i = 0; i < retiredBindlessIndices.size(); ++i)
+	{
+		--retiredBindlessIndices[i].framesLeft;
+		if (retiredBindlessIndices[i].framesLeft == 0)
+		{
+			freeBindlessIndices.push_back(retiredBindlessIndices[i].index);
+			std::swap(retiredBindlessIndices[i], retiredBindlessIndices.back());
+			--i;
+			retiredBindlessIndices.pop_back();
+		}
+	}
 
 	for (size_t i = 0; i < replacedDescriptors.size(); ++i)
 	{
 		--replacedDescriptors[i].framesNeededAlive;
 		if (replacedDescriptors[i].framesNeededAlive == 0)
 		{
+			replacedDescriptors[i].heap->Release(); // Ownership was taken over when it was replaced
 			std::swap(replacedDescriptors[i], replacedDescriptors.back());
 			--i;
 			replacedDescriptors.pop_back();
 		}
 	}
+
+	// Done before any descriptors are stored, so the frame region does not need copying
+	ResizeForPredictedUsage();
 }
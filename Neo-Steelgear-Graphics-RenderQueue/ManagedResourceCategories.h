@@ -1,6 +1,12 @@
 #pragma once
 
 #include <memory>
+#include <vector>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <utility>
+#include <stdexcept>
 
 #include <d3d12.h>
 
@@ -13,6 +19,19 @@
 
 #include "CategoryIdentifiers.h"
 #include "ManagedDescriptorHeap.h"
+#include "PooledHeapAllocatorGPU.h"
+#include "TLSFAllocator.h"
+#include "BuddyAllocator.h"
+#include "ResidencyManager.h"
+#include "SynchronizedHeapAllocatorGPU.h"
+#include "WorkerPool.h"
+
+enum class HeapPoolStrategy
+{
+	NONE,
+	TLSF,
+	BUDDY
+};
 
 struct UploaderSettings
 {
@@ -34,8 +53,23 @@ struct ResourceCategoriesSettings
 	std::shared_ptr<HeapAllocatorGPU> defaultStaticTexture2DAllocator = nullptr;
 	std::shared_ptr<HeapAllocatorGPU> defaultDynamicTexture2DAllocator = nullptr;
 
+	// With a pool strategy other than NONE, categories without an allocator of their own share heaps
+	// of categoryHeapPoolSize and larger chunks get a heap each. NONE gives every chunk its own heap.
+	// BUDDY rounds chunks up to powers of two, which suits categories whose heap sizes already are.
+	// Pooling is not used together with a residency budget, as shared heaps can only be evicted together
+	HeapPoolStrategy categoryHeapPoolStrategy = HeapPoolStrategy::NONE;
+	size_t categoryHeapPoolSize = 64 * 1024 * 1024;
+
 	UploaderSettings staticResourcesUploadSettings;
 	UploaderSettings dynamicResourcesUploadSettings;
+
+	// Each update thread records into its own copy list and gets an equal share of the upload heaps.
+	// Category heap allocators are serialized behind one mutex, so they can be shared between threads
+	size_t nrOfUpdateThreads = 1;
+
+	// Bytes of category default heap memory to keep resident, size_t(-1) disables residency tracking
+	size_t residencyBudget = size_t(-1);
+	ResidencyBackend* residencyBackend = nullptr;
 };
 
 template<FrameType Frames>
@@ -45,6 +79,7 @@ private:
 	typedef ResourceComponent ResourceCategory;
 
 	ID3D12Device* device;
+	ManagedDescriptorHeap<Frames>* bindlessDescriptorHeap = nullptr;
 
 	std::shared_ptr<HeapAllocatorGPU> staticBufferAllocator;
 	std::vector<FrameBufferComponent<1>> staticBufferCategories;
@@ -58,17 +93,81 @@ private:
 	std::shared_ptr<HeapAllocatorGPU> dynamicTexture2DAllocator;
 	std::vector<FrameTexture2DComponent<Frames>> dynamicTexture2DCategories;
 
-	FrameObject<ResourceUploader, Frames> staticResourcesUploader;
-	FrameObject<ResourceUploader, Frames> dynamicResourcesUploader;
+	std::vector<FrameObject<ResourceUploader, Frames>> staticResourcesUploaders;
+	std::vector<FrameObject<ResourceUploader, Frames>> dynamicResourcesUploaders;
+
+	// Residency sets are created in the same order as categories, so a set index is a dense category index
+	std::unique_ptr<ResidencyManager> residencyManager;
+	std::vector<std::unique_ptr<ResidencyTrackingHeapAllocatorGPU>> residencyAllocators;
+
+	// Workers persist between frames, every category allocator is wrapped to lock the same mutex
+	std::unique_ptr<WorkerPool> updateWorkers;
+	std::unique_ptr<std::mutex> heapAllocatorMutex;
+	std::vector<std::unique_ptr<SynchronizedHeapAllocatorGPU>> synchronizedAllocators;
 
+	struct CategoryOperations
+	{
+		ResourceComponent& (*getCategory)(ManagedResourceCategories& categories,
+			size_t localIndex) = nullptr;
+		void (*removeResource)(ManagedResourceCategories& categories,
+			size_t localIndex, const ResourceIndex& internalIndex) = nullptr;
+		void (*setResourceData)(ManagedResourceCategories& categories,
+			size_t localIndex, const ResourceIndex& internalIndex,
+			void* dataAddress, std::uint8_t subresourceIndex) = nullptr;
+		void (*setResourceDataBatch)(ManagedResourceCategories& categories,
+			size_t localIndex, const CategoryResourceIdentifier* identifiers,
+			size_t nrOfIdentifiers, unsigned char* dataStart, size_t dataStride,
+			std::uint8_t subresourceIndex) = nullptr;
+		void (*setResourceDataRange)(ManagedResourceCategories& categories,
+			size_t localIndex, const ResourceIndex& internalIndex,
+			void* dataAddress, size_t offsetInBytes, size_t sizeInBytes) = nullptr;
+		void (*transitionCategoryState)(ManagedResourceCategories& categories,
+			size_t localIndex, std::vector<D3D12_RESOURCE_BARRIER>& barriers,
+			D3D12_RESOURCE_STATES neededState,
+			std::optional<D3D12_RESOURCE_STATES> assumedInitialState) = nullptr;
+		CategoryResourceHandle (*getResourceHandle)(
+			const ManagedResourceCategories& categories, size_t localIndex,
+			const ResourceIndex& internalIndex) = nullptr;
+		void (*performUpdates)(ManagedResourceCategories& categories,
+			size_t localIndex, ID3D12GraphicsCommandList* list,
+			ResourceUploader& uploader) = nullptr;
+		void (*getInitializationBarriers)(ManagedResourceCategories& categories,
+			size_t localIndex, std::vector<D3D12_RESOURCE_BARRIER>& barriers) = nullptr;
+	};
+
+	// Indexed by the dense index of the category, so per resource calls avoid switching on the category type
+	std::vector<CategoryOperations> categoryOperations;
+	std::vector<CategoryIdentifier> categoryIdentifiers;
+	std::vector<std::uint64_t> descriptorVersions;
+	std::uint64_t nextDescriptorVersion = 0;
+
+	// Categories with pending updates or lifetime operations, kept until every frame has seen them
+	std::vector<std::uint8_t> categoryDirtyFrames;
+	std::vector<std::uint32_t> dirtyCategories;
+
+	template<typename ComponentType,
+		std::vector<ComponentType> ManagedResourceCategories::* Categories>
+	static CategoryOperations CreateBufferOperations();
+	template<typename ComponentType,
+		std::vector<ComponentType> ManagedResourceCategories::* Categories>
+	static CategoryOperations CreateTexture2DOperations();
+
+	CategoryIdentifier RegisterCategory(CategoryIdentifier identifier,
+		const CategoryOperations& operations);
+	void MarkDescriptorsChanged(const CategoryIdentifier& identifier);
+	void MarkCategoryDirty(const CategoryIdentifier& identifier);
+	HeapAllocatorGPU* GetResidencyAllocator(HeapAllocatorGPU* allocator);
+	HeapAllocatorGPU* GetCategoryAllocator(HeapAllocatorGPU* allocator);
+	std::shared_ptr<HeapAllocatorGPU> CreatePooledAllocator(
+		const ResourceCategoriesSettings& heapSettings, size_t chunkAlignment);
 	DescriptorAllocationInfo<BufferViewDesc> CreateDefaultBufferDAI(
 		ViewType viewType, size_t nrOfDescriptors);
 	DescriptorAllocationInfo<Texture2DViewDesc> CreateDefaultTexture2DDAI(
 		ViewType viewType, size_t nrOfDescriptors);
 
-	void UpdateDescriptorHeapHelper(bool dynamic, CategoryType CategoryType,
-		size_t localIndex, ResourceCategory& Category,
-		ManagedDescriptorHeap<Frames>& descriptorHeap);
+	ResourceCategory& GetCategory(const CategoryIdentifier& identifier);
+	void PerformCategoryUpdates(ID3D12GraphicsCommandList* list,
+		size_t workerIndex, std::atomic<size_t>& nextCategory);
 
 public:
 	ManagedResourceCategories() = default;
@@ -79,7 +178,8 @@ public:
 	ManagedResourceCategories& operator=(ManagedResourceCategories&& other) = default;
 
 	void Initialize(ID3D12Device* deviceToUse,
-		const ResourceCategoriesSettings& heapSettings);
+		const ResourceCategoriesSettings& heapSettings,
+		ManagedDescriptorHeap<Frames>* bindlessDescriptorHeapToUse = nullptr);
 
 	template<typename T>
 	CategoryIdentifier CreateBufferCategory(UpdateType categoryUpdateType,
@@ -105,6 +205,13 @@ public:
 
 	void SetResourceData(const CategoryResourceIdentifier& identifier, 
 		void* dataAddress, std::uint8_t subresourceIndex = 0);
+	// All identifiers must belong to the same category, element i is read from dataStart + i * dataStride
+	void SetResourceData(const CategoryResourceIdentifier* identifiers,
+		size_t nrOfIdentifiers, void* dataStart, size_t dataStride,
+		std::uint8_t subresourceIndex = 0);
+	// Uploads only the given bytes of a buffer in a copy updated category
+	void SetResourceDataRange(const CategoryResourceIdentifier& identifier,
+		void* dataAddress, size_t offsetInBytes, size_t sizeInBytes);
 
 	void TransitionCategoryState(const CategoryIdentifier& identifier,
 		std::vector<D3D12_RESOURCE_BARRIER>& barriers, D3D12_RESOURCE_STATES neededState,
@@ -113,8 +220,16 @@ public:
 	CategoryResourceHandle GetResourceHandle(const CategoryResourceIdentifier& identifier) const;
 
 	void UpdateDescriptorHeap(ManagedDescriptorHeap<Frames>& descriptorHeap);
+	// Writes bindless descriptors of resources created since the last call in one batch
+	void UpdateBindlessDescriptors();
 	void ActivateNewCategories(ID3D12GraphicsCommandList* list);
-	void UpdateCategories(ID3D12GraphicsCommandList* list);
+	void UpdateCategories(const std::vector<ID3D12GraphicsCommandList*>& lists);
+	size_t GetNrOfUpdateThreads() const;
+
+	// Categories only reached through bindless descriptors are not seen by queues and must be marked manually
+	void MarkCategoryUsed(const CategoryIdentifier& identifier);
+	void MarkCategoriesUsed(const std::vector<CategoryIdentifier>& identifiers);
+	void SetResidencyBudget(size_t budgetInBytes);
 
 	void SwapFrame() override;
 };
@@ -140,42 +255,319 @@ ManagedResourceCategories<Frames>::CreateDefaultTexture2DDAI(
 }
 
 template<FrameType Frames>
-inline void ManagedResourceCategories<Frames>::UpdateDescriptorHeapHelper(
-	bool dynamic, CategoryType categoryType, size_t localIndex,
-	ResourceCategory& category, ManagedDescriptorHeap<Frames>& descriptorHeap)
+template<typename ComponentType,
+	std::vector<ComponentType> ManagedResourceCategories<Frames>::* Categories>
+inline typename ManagedResourceCategories<Frames>::CategoryOperations
+ManagedResourceCategories<Frames>::CreateBufferOperations()
+{
+	CategoryOperations toReturn;
+
+	toReturn.getCategory = [](ManagedResourceCategories& categories,
+		size_t localIndex) -> ResourceComponent&
+	{
+		return (categories.*Categories)[localIndex];
+	};
+
+	toReturn.removeResource = [](ManagedResourceCategories& categories,
+		size_t localIndex, const ResourceIndex& internalIndex)
+	{
+		(categories.*Categories)[localIndex].RemoveComponent(internalIndex);
+	};
+
+	toReturn.setResourceData = [](ManagedResourceCategories& categories,
+		size_t localIndex, const ResourceIndex& internalIndex,
+		void* dataAddress, std::uint8_t)
+	{
+		(categories.*Categories)[localIndex].SetUpdateData(internalIndex,
+			dataAddress);
+	};
+
+	toReturn.setResourceDataBatch = [](ManagedResourceCategories& categories,
+		size_t localIndex, const CategoryResourceIdentifier* identifiers,
+		size_t nrOfIdentifiers, unsigned char* dataStart, size_t dataStride,
+		std::uint8_t)
+	{
+		(categories.*Categories)[localIndex].SetUpdateDataBatch(identifiers,
+			nrOfIdentifiers, dataStart, dataStride);
+	};
+
+	toReturn.setResourceDataRange = [](ManagedResourceCategories& categories,
+		size_t localIndex, const ResourceIndex& internalIndex,
+		void* dataAddress, size_t offsetInBytes, size_t sizeInBytes)
+	{
+		(categories.*Categories)[localIndex].SetUpdateDataRange(internalIndex,
+			dataAddress, offsetInBytes, sizeInBytes);
+	};
+
+	toReturn.transitionCategoryState = [](ManagedResourceCategories& categories,
+		size_t localIndex, std::vector<D3D12_RESOURCE_BARRIER>& barriers,
+		D3D12_RESOURCE_STATES neededState,
+		std::optional<D3D12_RESOURCE_STATES> assumedInitialState)
+	{
+		(categories.*Categories)[localIndex].ChangeToState(barriers, neededState,
+			assumedInitialState);
+	};
+
+	toReturn.getResourceHandle = [](const ManagedResourceCategories& categories,
+		size_t localIndex, const ResourceIndex& internalIndex)
+	{
+		BufferHandle internalHandle =
+			(categories.*Categories)[localIndex].GetBufferHandle(internalIndex);
+		CategoryResourceHandle handle;
+		handle.resource = internalHandle.resource;
+		handle.offset = internalHandle.startOffset;
+		handle.nrOfElements = internalHandle.nrOfElements;
+		return handle;
+	};
+
+	toReturn.performUpdates = [](ManagedResourceCategories& categories,
+		size_t localIndex, ID3D12GraphicsCommandList* list,
+		ResourceUploader& uploader)
+	{
+		(categories.*Categories)[localIndex].PerformUpdates(list, uploader);
+	};
+
+	toReturn.getInitializationBarriers = [](ManagedResourceCategories& categories,
+		size_t localIndex, std::vector<D3D12_RESOURCE_BARRIER>& barriers)
+	{
+		(categories.*Categories)[localIndex].GetInitializationBarriers(barriers);
+	};
+
+	return toReturn;
+}
+
+template<FrameType Frames>
+template<typename ComponentType,
+	std::vector<ComponentType> ManagedResourceCategories<Frames>::* Categories>
+inline typename ManagedResourceCategories<Frames>::CategoryOperations
+ManagedResourceCategories<Frames>::CreateTexture2DOperations()
+{
+	CategoryOperations toReturn;
+
+	toReturn.getCategory = [](ManagedResourceCategories& categories,
+		size_t localIndex) -> ResourceComponent&
+	{
+		return (categories.*Categories)[localIndex];
+	};
+
+	toReturn.removeResource = [](ManagedResourceCategories& categories,
+		size_t localIndex, const ResourceIndex& internalIndex)
+	{
+		(categories.*Categories)[localIndex].RemoveComponent(internalIndex);
+	};
+
+	toReturn.setResourceData = [](ManagedResourceCategories& categories,
+		size_t localIndex, const ResourceIndex& internalIndex,
+		void* dataAddress, std::uint8_t subresourceIndex)
+	{
+		(categories.*Categories)[localIndex].SetUpdateData(internalIndex,
+			dataAddress, subresourceIndex);
+	};
+
+	toReturn.setResourceDataBatch = [](ManagedResourceCategories& categories,
+		size_t localIndex, const CategoryResourceIdentifier* identifiers,
+		size_t nrOfIdentifiers, unsigned char* dataStart, size_t dataStride,
+		std::uint8_t subresourceIndex)
+	{
+		ComponentType& category = (categories.*Categories)[localIndex];
+
+		for (size_t i = 0; i < nrOfIdentifiers; ++i)
+		{
+			category.SetUpdateData(identifiers[i].internalIndex,
+				dataStart + i * dataStride, subresourceIndex);
+		}
+	};
+
+	toReturn.transitionCategoryState = [](ManagedResourceCategories& categories,
+		size_t localIndex, std::vector<D3D12_RESOURCE_BARRIER>& barriers,
+		D3D12_RESOURCE_STATES neededState,
+		std::optional<D3D12_RESOURCE_STATES> assumedInitialState)
+	{
+		// Core transitions every texture of the category, one barrier each, whatever state it is in.
+		// Queues that touch only some of the textures request them individually to avoid that
+		(categories.*Categories)[localIndex].TransitionAllTextures(barriers,
+			neededState, assumedInitialState);
+	};
+
+	toReturn.getResourceHandle = [](const ManagedResourceCategories& categories,
+		size_t localIndex, const ResourceIndex& internalIndex)
+	{
+		TextureHandle internalHandle =
+			(categories.*Categories)[localIndex].GetTextureHandle(internalIndex);
+		CategoryResourceHandle handle;
+		handle.resource = internalHandle.resource;
+		handle.offset = 0;
+		handle.nrOfElements = 1;
+		return handle;
+	};
+
+	toReturn.performUpdates = [](ManagedResourceCategories& categories,
+		size_t localIndex, ID3D12GraphicsCommandList* list,
+		ResourceUploader& uploader)
+	{
+		(categories.*Categories)[localIndex].PerformUpdates(list, uploader);
+	};
+
+	toReturn.getInitializationBarriers = [](ManagedResourceCategories& categories,
+		size_t localIndex, std::vector<D3D12_RESOURCE_BARRIER>& barriers)
+	{
+		(categories.*Categories)[localIndex].GetInitializationBarriers(barriers);
+	};
+
+	return toReturn;
+}
+
+template<FrameType Frames>
+inline CategoryIdentifier ManagedResourceCategories<Frames>::RegisterCategory(
+	CategoryIdentifier identifier, const CategoryOperations& operations)
 {
-	CategoryIdentifier identifier;
-	identifier.type = categoryType;
-	identifier.localIndex = localIndex;
-	identifier.dynamicCategory = dynamic;
+	identifier.denseIndex = static_cast<std::uint32_t>(categoryIdentifiers.size());
+	categoryOperations.push_back(operations);
+	categoryIdentifiers.push_back(identifier);
+	descriptorVersions.push_back(++nextDescriptorVersion);
+	categoryDirtyFrames.push_back(0);
 
-	descriptorHeap.AddCategoryDescriptors(identifier, category);
+	return identifier;
+}
+
+template<FrameType Frames>
+inline void ManagedResourceCategories<Frames>::MarkDescriptorsChanged(
+	const CategoryIdentifier& identifier)
+{
+	descriptorVersions[identifier.denseIndex] = ++nextDescriptorVersion;
+}
+
+template<FrameType Frames>
+inline void ManagedResourceCategories<Frames>::MarkCategoryDirty(
+	const CategoryIdentifier& identifier)
+{
+	// One extra frame covers changes made after this frame's updates were recorded
+	std::uint8_t framesToKeep = identifier.dynamicCategory ? Frames + 1 : 2;
+	std::uint8_t& dirtyFrames = categoryDirtyFrames[identifier.denseIndex];
+
+	if (dirtyFrames == 0)
+		dirtyCategories.push_back(identifier.denseIndex);
+
+	dirtyFrames = framesToKeep;
+}
+
+template<FrameType Frames>
+inline HeapAllocatorGPU* ManagedResourceCategories<Frames>::GetResidencyAllocator(
+	HeapAllocatorGPU* allocator)
+{
+	if (residencyManager == nullptr)
+		return allocator;
+
+	size_t residencySet = residencyManager->CreateResidencySet();
+	residencyAllocators.push_back(std::make_unique<ResidencyTrackingHeapAllocatorGPU>(
+		allocator, residencyManager.get(), residencySet));
+
+	return residencyAllocators.back().get();
+}
+
+template<FrameType Frames>
+inline HeapAllocatorGPU* ManagedResourceCategories<Frames>::GetCategoryAllocator(
+	HeapAllocatorGPU* allocator)
+{
+	allocator = GetResidencyAllocator(allocator);
+
+	if (updateWorkers->GetNrOfWorkers() == 0)
+		return allocator;
+
+	// Outermost, so residency bookkeeping is also done while holding the lock
+	synchronizedAllocators.push_back(std::make_unique<SynchronizedHeapAllocatorGPU>(
+		allocator, heapAllocatorMutex.get()));
+
+	return synchronizedAllocators.back().get();
+}
+
+template<FrameType Frames>
+inline std::shared_ptr<HeapAllocatorGPU> ManagedResourceCategories<Frames>::CreatePooledAllocator(
+	const ResourceCategoriesSettings& heapSettings, size_t chunkAlignment)
+{
+	if (heapSettings.categoryHeapPoolStrategy == HeapPoolStrategy::BUDDY)
+	{
+		std::shared_ptr<PooledHeapAllocatorGPU<BuddyAllocator>> toReturn(
+			new PooledHeapAllocatorGPU<BuddyAllocator>());
+		toReturn->Initialize(device, heapSettings.categoryHeapPoolSize, chunkAlignment);
+		return toReturn;
+	}
+
+	std::shared_ptr<PooledHeapAllocatorGPU<TLSFAllocator>> toReturn(
+		new PooledHeapAllocatorGPU<TLSFAllocator>());
+	toReturn->Initialize(device, heapSettings.categoryHeapPoolSize, chunkAlignment);
+	return toReturn;
+}
+
+template<FrameType Frames>
+inline ResourceComponent& ManagedResourceCategories<Frames>::GetCategory(
+	const CategoryIdentifier& identifier)
+{
+	return categoryOperations[identifier.denseIndex].getCategory(*this,
+		identifier.localIndex);
 }
 
 template<FrameType Frames>
 inline void ManagedResourceCategories<Frames>::Initialize(ID3D12Device* deviceToUse,
-	const ResourceCategoriesSettings& heapSettings)
+	const ResourceCategoriesSettings& heapSettings,
+	ManagedDescriptorHeap<Frames>* bindlessDescriptorHeapToUse)
 {
 	device = deviceToUse;
+	bindlessDescriptorHeap = bindlessDescriptorHeapToUse;
+
+	std::shared_ptr<HeapAllocatorGPU> defaultBufferAllocator;
+	std::shared_ptr<HeapAllocatorGPU> defaultTextureAllocator;
 
-	std::shared_ptr<MultiHeapAllocatorGPU> defaultAllocator(new MultiHeapAllocatorGPU());
-	defaultAllocator->Initialize(device);
+	if (heapSettings.categoryHeapPoolStrategy == HeapPoolStrategy::NONE ||
+		heapSettings.residencyBudget != size_t(-1))
+	{
+		std::shared_ptr<MultiHeapAllocatorGPU> defaultAllocator(new MultiHeapAllocatorGPU());
+		defaultAllocator->Initialize(device);
+		defaultBufferAllocator = defaultAllocator;
+		defaultTextureAllocator = defaultAllocator;
+	}
+	else
+	{
+		// Texture chunks are aligned for multisampled textures, which need a larger placement alignment
+		defaultBufferAllocator = CreatePooledAllocator(heapSettings,
+			D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
+		defaultTextureAllocator = CreatePooledAllocator(heapSettings,
+			D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT);
+	}
 
 	staticBufferAllocator = heapSettings.defaultStaticBufferAllocator != nullptr ?
-		heapSettings.defaultStaticBufferAllocator : defaultAllocator;
+		heapSettings.defaultStaticBufferAllocator : defaultBufferAllocator;
 	dynamicBufferAllocator = heapSettings.defaultDynamicBufferAllocator != nullptr ?
-		heapSettings.defaultDynamicBufferAllocator : defaultAllocator;
+		heapSettings.defaultDynamicBufferAllocator : defaultBufferAllocator;
 	staticTexture2DAllocator = heapSettings.defaultStaticTexture2DAllocator != nullptr ?
-		heapSettings.defaultStaticTexture2DAllocator : defaultAllocator;
+		heapSettings.defaultStaticTexture2DAllocator : defaultTextureAllocator;
 	dynamicTexture2DAllocator = heapSettings.defaultDynamicTexture2DAllocator != nullptr ?
-		heapSettings.defaultDynamicTexture2DAllocator : defaultAllocator;
+		heapSettings.defaultDynamicTexture2DAllocator : defaultTextureAllocator;
 
-	staticResourcesUploader.Initialize(&ResourceUploader::Initialize, device,
-		heapSettings.staticResourcesUploadSettings.heapSize,
-		heapSettings.staticResourcesUploadSettings.allocationStrategy);
-	dynamicResourcesUploader.Initialize(&ResourceUploader::Initialize, device,
-		heapSettings.dynamicResourcesUploadSettings.heapSize,
-		heapSettings.dynamicResourcesUploadSettings.allocationStrategy);
+	size_t nrOfUpdateThreads = heapSettings.nrOfUpdateThreads != 0 ?
+		heapSettings.nrOfUpdateThreads : 1;
+	updateWorkers = std::make_unique<WorkerPool>();
+	updateWorkers->Initialize(nrOfUpdateThreads - 1);
+	heapAllocatorMutex = std::make_unique<std::mutex>();
+	staticResourcesUploaders.resize(nrOfUpdateThreads);
+	dynamicResourcesUploaders.resize(nrOfUpdateThreads);
+
+	for (size_t i = 0; i < nrOfUpdateThreads; ++i)
+	{
+		staticResourcesUploaders[i].Initialize(&ResourceUploader::Initialize, device,
+			heapSettings.staticResourcesUploadSettings.heapSize / nrOfUpdateThreads,
+			heapSettings.staticResourcesUploadSettings.allocationStrategy);
+		dynamicResourcesUploaders[i].Initialize(&ResourceUploader::Initialize, device,
+			heapSettings.dynamicResourcesUploadSettings.heapSize / nrOfUpdateThreads,
+			heapSettings.dynamicResourcesUploadSettings.allocationStrategy);
+	}
+
+	if (heapSettings.residencyBudget != size_t(-1))
+	{
+		residencyManager = std::make_unique<ResidencyManager>();
+		residencyManager->Initialize(device, heapSettings.residencyBudget, Frames,
+			heapSettings.residencyBackend);
+	}
 }
 
 template<FrameType Frames>
@@ -207,6 +599,7 @@ inline CategoryIdentifier ManagedResourceCategories<Frames>::CreateBufferCategor
 	toReturn.dynamicCategory = dynamic;
 	toReturn.type = CategoryType::BUFFER;
 	std::vector<DescriptorAllocationInfo<BufferViewDesc>> dai;
+	CategoryOperations operations;
 
 	if (cbv)
 		dai.push_back(CreateDefaultBufferDAI(ViewType::CBV, nrOfStartingDescriptors));
@@ -221,10 +614,14 @@ inline CategoryIdentifier ManagedResourceCategories<Frames>::CreateBufferCategor
 
 		if (categoryInfo.memoryInfo.heapAllocator == nullptr)
 			categoryInfo.memoryInfo.heapAllocator = dynamicBufferAllocator.get();
+		categoryInfo.memoryInfo.heapAllocator =
+			GetCategoryAllocator(categoryInfo.memoryInfo.heapAllocator);
 
 		toAdd.Initialize(device, categoryUpdateType, categoryInfo, dai);
 		dynamicBufferCategories.push_back(std::move(toAdd));
 		toReturn.localIndex = dynamicBufferCategories.size() - 1;
+		operations = CreateBufferOperations<FrameBufferComponent<Frames>,
+			&ManagedResourceCategories::dynamicBufferCategories>();
 	}
 	else
 	{
@@ -232,13 +629,17 @@ inline CategoryIdentifier ManagedResourceCategories<Frames>::CreateBufferCategor
 
 		if (categoryInfo.memoryInfo.heapAllocator == nullptr)
 			categoryInfo.memoryInfo.heapAllocator = staticBufferAllocator.get();
+		categoryInfo.memoryInfo.heapAllocator =
+			GetCategoryAllocator(categoryInfo.memoryInfo.heapAllocator);
 
 		toAdd.Initialize(device, categoryUpdateType, categoryInfo, dai);
 		staticBufferCategories.push_back(std::move(toAdd));
 		toReturn.localIndex = staticBufferCategories.size() - 1;
+		operations = CreateBufferOperations<FrameBufferComponent<1>,
+			&ManagedResourceCategories::staticBufferCategories>();
 	}
 
-	return toReturn;
+	return RegisterCategory(toReturn, operations);
 }
 
 template<FrameType Frames>
@@ -252,6 +653,7 @@ inline CategoryIdentifier ManagedResourceCategories<Frames>::CreateTexture2DCate
 	toReturn.dynamicCategory = dynamic;
 	toReturn.type = CategoryType::TEXTURE2D;
 	std::vector<DescriptorAllocationInfo<Texture2DViewDesc>> dai;
+	CategoryOperations operations;
 
 	if (srv)
 		dai.push_back(CreateDefaultTexture2DDAI(ViewType::SRV, nrOfStartingDescriptors));
@@ -268,10 +670,14 @@ inline CategoryIdentifier ManagedResourceCategories<Frames>::CreateTexture2DCate
 
 		if (categoryInfo.memoryInfo.heapAllocator == nullptr)
 			categoryInfo.memoryInfo.heapAllocator = dynamicTexture2DAllocator.get();
+		categoryInfo.memoryInfo.heapAllocator =
+			GetCategoryAllocator(categoryInfo.memoryInfo.heapAllocator);
 
 		toAdd.Initialize(device, categoryUpdateType, categoryInfo, dai);
 		dynamicTexture2DCategories.push_back(std::move(toAdd));
 		toReturn.localIndex = dynamicTexture2DCategories.size() - 1;
+		operations = CreateTexture2DOperations<FrameTexture2DComponent<Frames>,
+			&ManagedResourceCategories::dynamicTexture2DCategories>();
 	}
 	else
 	{
@@ -279,13 +685,17 @@ inline CategoryIdentifier ManagedResourceCategories<Frames>::CreateTexture2DCate
 
 		if (categoryInfo.memoryInfo.heapAllocator == nullptr)
 			categoryInfo.memoryInfo.heapAllocator = staticTexture2DAllocator.get();
+		categoryInfo.memoryInfo.heapAllocator =
+			GetCategoryAllocator(categoryInfo.memoryInfo.heapAllocator);
 
 		toAdd.Initialize(device, categoryUpdateType, categoryInfo, dai);
 		staticTexture2DCategories.push_back(std::move(toAdd));
 		toReturn.localIndex = staticTexture2DCategories.size() - 1;
+		operations = CreateTexture2DOperations<FrameTexture2DComponent<1>,
+			&ManagedResourceCategories::staticTexture2DCategories>();
 	}
 
-	return toReturn;
+	return RegisterCategory(toReturn, operations);
 }
 
 template<FrameType Frames>
@@ -304,8 +714,16 @@ inline CategoryResourceIdentifier ManagedResourceCategories<Frames>::CreateBuffe
 	{
 		internalIndex = staticBufferCategories[category.localIndex].CreateBuffer(
 			nrOfElements, replacementViews);
+
+		if (bindlessDescriptorHeap != nullptr)
+		{
+			bindlessDescriptorHeap->AddBindlessResource({ category, internalIndex },
+				staticBufferCategories[category.localIndex]);
+		}
 	}
 
+	MarkDescriptorsChanged(category);
+	MarkCategoryDirty(category);
 	return { category, internalIndex };
 }
 
@@ -329,8 +747,16 @@ inline CategoryResourceIdentifier ManagedResourceCategories<Frames>::CreateTextu
 		internalIndex = staticTexture2DCategories[category.localIndex].CreateTexture(
 			width, height, arraySize, mipLevels, sampleCount, sampleQuality,
 			optimalClearValue, replacementViews);
+
+		if (bindlessDescriptorHeap != nullptr)
+		{
+			bindlessDescriptorHeap->AddBindlessResource({ category, internalIndex },
+				staticTexture2DCategories[category.localIndex]);
+		}
 	}
 
+	MarkDescriptorsChanged(category);
+	MarkCategoryDirty(category);
 	return { category, internalIndex };
 }
 
@@ -338,75 +764,64 @@ template<FrameType Frames>
 inline void ManagedResourceCategories<Frames>::RemoveResource(
 	const CategoryResourceIdentifier& identifier)
 {
-	size_t localIndex = identifier.categoryIdentifier.localIndex;
-	ResourceIndex internalIndex = identifier.internalIndex;
+	const CategoryIdentifier& category = identifier.categoryIdentifier;
 
-	switch (identifier.categoryIdentifier.type)
-	{
-	case CategoryType::BUFFER:
-		if (identifier.categoryIdentifier.dynamicCategory == true)
-		{
-			dynamicBufferCategories[localIndex].RemoveComponent(internalIndex);
-		}
-		else
-		{
-			staticBufferCategories[localIndex].RemoveComponent(internalIndex);
-		}
-		break;
-	case CategoryType::TEXTURE2D:
-		if (identifier.categoryIdentifier.dynamicCategory == true)
-		{
-			dynamicTexture2DCategories[localIndex].RemoveComponent(internalIndex);
-		}
-		else
-		{
-			staticTexture2DCategories[localIndex].RemoveComponent(internalIndex);
-		}
-		break;
-	default:
-		throw std::runtime_error("Unknown category type when removing resource");
-		break;
-	}
+	if (bindlessDescriptorHeap != nullptr)
+		bindlessDescriptorHeap->RemoveBindlessResource(identifier);
+
+	categoryOperations[category.denseIndex].removeResource(*this,
+		category.localIndex, identifier.internalIndex);
+	MarkDescriptorsChanged(category);
+	MarkCategoryDirty(category);
 }
 
 template<FrameType Frames>
-void ManagedResourceCategories<Frames>::SetResourceData(
+inline void ManagedResourceCategories<Frames>::SetResourceData(
 	const CategoryResourceIdentifier& identifier, void* dataAddress,
 	std::uint8_t subresourceIndex)
 {
-	size_t localIndex = identifier.categoryIdentifier.localIndex;
-	ResourceIndex internalIndex = identifier.internalIndex;
+	const CategoryIdentifier& category = identifier.categoryIdentifier;
+	categoryOperations[category.denseIndex].setResourceData(*this,
+		category.localIndex, identifier.internalIndex, dataAddress, subresourceIndex);
+	MarkCategoryDirty(category);
+}
+
+template<FrameType Frames>
+inline void ManagedResourceCategories<Frames>::SetResourceData(
+	const CategoryResourceIdentifier* identifiers, size_t nrOfIdentifiers,
+	void* dataStart, size_t dataStride, std::uint8_t subresourceIndex)
+{
+	if (nrOfIdentifiers == 0)
+		return;
 
-	switch (identifier.categoryIdentifier.type)
+	const CategoryIdentifier& category = identifiers[0].categoryIdentifier;
+
+	for (size_t i = 1; i < nrOfIdentifiers; ++i)
 	{
-	case CategoryType::BUFFER:
-		if (identifier.categoryIdentifier.dynamicCategory == true)
-		{
-			dynamicBufferCategories[localIndex].SetUpdateData(internalIndex,
-				dataAddress);
-		}
-		else
-		{
-			staticBufferCategories[localIndex].SetUpdateData(internalIndex,
-				dataAddress);
-		}
-		break;
-	case CategoryType::TEXTURE2D:
-		if (identifier.categoryIdentifier.dynamicCategory == true)
-		{
-			dynamicTexture2DCategories[localIndex].SetUpdateData(internalIndex,
-				dataAddress, subresourceIndex);
-		}
-		else
-		{
-			staticTexture2DCategories[localIndex].SetUpdateData(internalIndex,
-				dataAddress, subresourceIndex);
-		}
-		break;
-	default:
-		throw std::runtime_error("Unknown category type when setting resource data");
-		break;
+		if (!(identifiers[i].categoryIdentifier == category))
+			throw std::runtime_error("Batched resource data updates must all target the same category");
 	}
+
+	categoryOperations[category.denseIndex].setResourceDataBatch(*this,
+		category.localIndex, identifiers, nrOfIdentifiers,
+		static_cast<unsigned char*>(dataStart), dataStride, subresourceIndex);
+	MarkCategoryDirty(category);
+}
+
+template<FrameType Frames>
+inline void ManagedResourceCategories<Frames>::SetResourceDataRange(
+	const CategoryResourceIdentifier& identifier, void* dataAddress,
+	size_t offsetInBytes, size_t sizeInBytes)
+{
+	const CategoryIdentifier& category = identifier.categoryIdentifier;
+
+	if (categoryOperations[category.denseIndex].setResourceDataRange == nullptr)
+		throw std::runtime_error("Ranged resource data updates are only supported for buffers");
+
+	categoryOperations[category.denseIndex].setResourceDataRange(*this,
+		category.localIndex, identifier.internalIndex, dataAddress,
+		offsetInBytes, sizeInBytes);
+	MarkCategoryDirty(category);
 }
 
 template<FrameType Frames>
@@ -414,141 +829,80 @@ inline void ManagedResourceCategories<Frames>::TransitionCategoryState(
 	const CategoryIdentifier& identifier, std::vector<D3D12_RESOURCE_BARRIER>& barriers,
 	D3D12_RESOURCE_STATES neededState, std::optional<D3D12_RESOURCE_STATES> assumedInitialState)
 {
-	switch (identifier.type)
-	{
-	case CategoryType::BUFFER:
-		if (identifier.dynamicCategory == true)
-		{
-			dynamicBufferCategories[identifier.localIndex].ChangeToState(
-				barriers, neededState, assumedInitialState);
-		}
-		else
-		{
-			staticBufferCategories[identifier.localIndex].ChangeToState(
-				barriers, neededState, assumedInitialState);
-		}
-	case CategoryType::TEXTURE2D:
-		if (identifier.dynamicCategory == true)
-		{
-			dynamicTexture2DCategories[identifier.localIndex].TransitionAllTextures(
-				barriers, neededState, assumedInitialState);
-		}
-		else
-		{
-			staticTexture2DCategories[identifier.localIndex].TransitionAllTextures(
-				barriers, neededState, assumedInitialState);
-		}
-		break;
-	default:
-		throw std::runtime_error("Attempting to transition Category of unknown type");
-		break;
-	}
+	categoryOperations[identifier.denseIndex].transitionCategoryState(*this,
+		identifier.localIndex, barriers, neededState, assumedInitialState);
 }
 
 template<FrameType Frames>
 inline void ManagedResourceCategories<Frames>::SwapFrame()
 {
-	for (auto& category : staticBufferCategories)
-		category.SwapFrame();
-
+	// Static categories have no stored lifetime operations or frame to advance
 	for (auto& category : dynamicBufferCategories)
 		category.SwapFrame();
 
-	for (auto& category : staticTexture2DCategories)
-		category.SwapFrame();
-
 	for (auto& category : dynamicTexture2DCategories)
 		category.SwapFrame();
 
-	staticResourcesUploader.SwapFrame();
-	staticResourcesUploader.Active().RestoreUsedMemory();
-	dynamicResourcesUploader.SwapFrame();
-	dynamicResourcesUploader.Active().RestoreUsedMemory();
+	for (size_t i = 0; i < dirtyCategories.size(); ++i)
+	{
+		if (--categoryDirtyFrames[dirtyCategories[i]] == 0)
+		{
+			std::swap(dirtyCategories[i], dirtyCategories.back());
+			dirtyCategories.pop_back();
+			--i;
+		}
+	}
+
+	if (residencyManager != nullptr)
+		residencyManager->SwapFrame();
+
+	for (auto& uploader : staticResourcesUploaders)
+	{
+		uploader.SwapFrame();
+		uploader.Active().RestoreUsedMemory();
+	}
+
+	for (auto& uploader : dynamicResourcesUploaders)
+	{
+		uploader.SwapFrame();
+		uploader.Active().RestoreUsedMemory();
+	}
 }
 
 template<FrameType Frames>
 inline CategoryResourceHandle ManagedResourceCategories<Frames>::GetResourceHandle(
 	const CategoryResourceIdentifier& identifier) const
 {
-	CategoryResourceHandle toReturn;
-
-	switch (identifier.categoryIdentifier.type)
-	{
-	case CategoryType::BUFFER:
-		if (identifier.categoryIdentifier.dynamicCategory == true)
-		{
-			BufferHandle internalHandle =
-				dynamicBufferCategories[identifier.categoryIdentifier.localIndex].GetBufferHandle(
-					identifier.internalIndex);
-			toReturn.resource = internalHandle.resource;
-			toReturn.offset = internalHandle.startOffset;
-			toReturn.nrOfElements = internalHandle.nrOfElements;
-		}
-		else
-		{
-			BufferHandle internalHandle =
-				 staticBufferCategories[identifier.categoryIdentifier.localIndex].GetBufferHandle(
-					identifier.internalIndex);
-			toReturn.resource = internalHandle.resource;
-			toReturn.offset = internalHandle.startOffset;
-			toReturn.nrOfElements = internalHandle.nrOfElements;
-		}
-		break;
-	case CategoryType::TEXTURE2D:
-		if (identifier.categoryIdentifier.dynamicCategory == true)
-		{
-			TextureHandle internalHandle = 
-				dynamicTexture2DCategories[identifier.categoryIdentifier.localIndex].GetTextureHandle(
-					identifier.internalIndex);
-			toReturn.resource = internalHandle.resource;
-			toReturn.offset = 0;
-			toReturn.nrOfElements = 1;
-		}
-		else
-		{
-			TextureHandle internalHandle =
-				staticTexture2DCategories[identifier.categoryIdentifier.localIndex].GetTextureHandle(
-					identifier.internalIndex);
-			toReturn.resource = internalHandle.resource;
-			toReturn.offset = 0;
-			toReturn.nrOfElements = 1;
-		}
-		break;
-	default:
-		throw std::runtime_error("Unknown category type when getting resource handle");
-		break;
-	}
-
-	return toReturn;
+	const CategoryIdentifier& category = identifier.categoryIdentifier;
+	return categoryOperations[category.denseIndex].getResourceHandle(*this,
+		category.localIndex, identifier.internalIndex);
 }
 
 template<FrameType Frames>
 inline void ManagedResourceCategories<Frames>::UpdateDescriptorHeap(
 	ManagedDescriptorHeap<Frames>& descriptorHeap)
 {
-	for (size_t i = 0; i < staticBufferCategories.size(); ++i)
+	for (const CategoryIdentifier& identifier : categoryIdentifiers)
 	{
-		UpdateDescriptorHeapHelper(false, CategoryType::BUFFER,
-			i, staticBufferCategories[i], descriptorHeap);
+		descriptorHeap.AddCategoryDescriptors(identifier, GetCategory(identifier),
+			descriptorVersions[identifier.denseIndex]);
 	}
 
-	for (size_t i = 0; i < dynamicBufferCategories.size(); ++i)
-	{
-		UpdateDescriptorHeapHelper(true, CategoryType::BUFFER,
-			i, dynamicBufferCategories[i], descriptorHeap);
-	}
+	descriptorHeap.FlushQueuedCopies();
+	UpdateBindlessDescriptors();
+}
 
-	for (size_t i = 0; i < staticTexture2DCategories.size(); ++i)
-	{
-		UpdateDescriptorHeapHelper(false, CategoryType::TEXTURE2D,
-			i, staticTexture2DCategories[i], descriptorHeap);
-	}
+template<FrameType Frames>
+inline void ManagedResourceCategories<Frames>::UpdateBindlessDescriptors()
+{
+	if (bindlessDescriptorHeap == nullptr)
+		return;
 
-	for (size_t i = 0; i < dynamicTexture2DCategories.size(); ++i)
-	{
-		UpdateDescriptorHeapHelper(true, CategoryType::TEXTURE2D,
-			i, dynamicTexture2DCategories[i], descriptorHeap);
-	}
+	bindlessDescriptorHeap->StorePendingBindlessDescriptors(
+		[this](const CategoryIdentifier& identifier) -> const ResourceComponent&
+		{
+			return GetCategory(identifier);
+		});
 }
 
 template<FrameType Frames>
@@ -557,17 +911,11 @@ inline void ManagedResourceCategories<Frames>::ActivateNewCategories(
 {
 	static std::vector<D3D12_RESOURCE_BARRIER> barriers;
 
-	for (auto& Category : staticBufferCategories)
-		Category.GetInitializationBarriers(barriers);
-
-	for (auto& Category : dynamicBufferCategories)
-		Category.GetInitializationBarriers(barriers);
-
-	for (auto& Category : staticTexture2DCategories)
-		Category.GetInitializationBarriers(barriers);
-
-	for (auto& Category : dynamicTexture2DCategories)
-		Category.GetInitializationBarriers(barriers);
+	for (std::uint32_t denseIndex : dirtyCategories)
+	{
+		categoryOperations[denseIndex].getInitializationBarriers(*this,
+			categoryIdentifiers[denseIndex].localIndex, barriers);
+	}
 
 	if (barriers.size() != 0)
 	{
@@ -576,19 +924,73 @@ inline void ManagedResourceCategories<Frames>::ActivateNewCategories(
 	}
 }
 
+template<FrameType Frames>
+inline void ManagedResourceCategories<Frames>::PerformCategoryUpdates(
+	ID3D12GraphicsCommandList* list, size_t workerIndex,
+	std::atomic<size_t>& nextCategory)
+{
+	ResourceUploader& staticUploader = staticResourcesUploaders[workerIndex].Active();
+	ResourceUploader& dynamicUploader = dynamicResourcesUploaders[workerIndex].Active();
+
+	for (size_t i = nextCategory++; i < dirtyCategories.size(); i = nextCategory++)
+	{
+		std::uint32_t denseIndex = dirtyCategories[i];
+		const CategoryIdentifier& identifier = categoryIdentifiers[denseIndex];
+		categoryOperations[denseIndex].performUpdates(*this, identifier.localIndex,
+			list, identifier.dynamicCategory ? dynamicUploader : staticUploader);
+	}
+}
+
 template<FrameType Frames>
 inline void ManagedResourceCategories<Frames>::UpdateCategories(
-	ID3D12GraphicsCommandList* list)
+	const std::vector<ID3D12GraphicsCommandList*>& lists)
 {
-	for (auto& category : staticBufferCategories)
-		category.PerformUpdates(list, staticResourcesUploader.Active());
+	if (residencyManager != nullptr)
+	{
+		for (std::uint32_t denseIndex : dirtyCategories)
+			residencyManager->MarkUsed(denseIndex);
+	}
 
-	for (auto& category : dynamicBufferCategories)
-		category.PerformUpdates(list, dynamicResourcesUploader.Active());
+	size_t nrOfWorkers = lists.size() < staticResourcesUploaders.size() ?
+		lists.size() : staticResourcesUploaders.size();
+	std::atomic<size_t> nextCategory = 0;
 
-	for (auto& category : staticTexture2DCategories)
-		category.PerformUpdates(list, staticResourcesUploader.Active());
+	updateWorkers->Run(nrOfWorkers, [&](size_t workerIndex)
+	{
+		PerformCategoryUpdates(lists[workerIndex], workerIndex, nextCategory);
+	});
+}
 
-	for (auto& category : dynamicTexture2DCategories)
-		category.PerformUpdates(list, dynamicResourcesUploader.Active());
+template<FrameType Frames>
+inline size_t ManagedResourceCategories<Frames>::GetNrOfUpdateThreads() const
+{
+	return staticResourcesUploaders.size();
+}
+
+template<FrameType Frames>
+inline void ManagedResourceCategories<Frames>::MarkCategoryUsed(
+	const CategoryIdentifier& identifier)
+{
+	if (residencyManager != nullptr)
+		residencyManager->MarkUsed(identifier.denseIndex);
+}
+
+template<FrameType Frames>
+inline void ManagedResourceCategories<Frames>::MarkCategoriesUsed(
+	const std::vector<CategoryIdentifier>& identifiers)
+{
+	if (residencyManager == nullptr)
+		return;
+
+	for (const CategoryIdentifier& identifier : identifiers)
+		residencyManager->MarkUsed(identifier.denseIndex);
+}
+
+template<FrameType Frames>
+inline void ManagedResourceCategories<Frames>::SetResidencyBudget(size_t budgetInBytes)
+{
+	if (residencyManager == nullptr)
+		throw std::runtime_error("Residency tracking was not enabled when initializing the resource categories");
+
+	residencyManager->SetBudget(budgetInBytes);
 }
\ No newline at end of file
@@ -2,6 +2,11 @@
 
 #include <d3d12.h>
 #include <optional>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
 
 #include "FrameResourceComponent.h"
 #include "BufferComponent.h"
@@ -22,11 +27,29 @@ private:
 	typedef typename FrameResourceComponent<BufferComponent, Frames,
 		BufferCreationOperation>::LifetimeOperationType BufferLifetimeOperationType;
 
+	static_assert(Frames < 64, "Dirty ranges track pending frames in a 64 bit mask");
+
+	struct DirtyRange
+	{
+		ResourceIndex resourceIndex;
+		size_t offset = 0;
+		size_t size = 0;
+		std::uint64_t pendingFrames = 0;
+	};
+
 	size_t bufferSize = 0;
 	size_t bufferAlignment = 0;
+	UpdateType updateType = UpdateType::NONE;
 	BufferComponentData componentData;
+	std::vector<DirtyRange> dirtyRanges;
 
-	void HandleStoredOperations() override;
+	typedef typename FrameResourceComponent<BufferComponent, Frames,
+		BufferCreationOperation>::StoredLifetimeOperation BufferStoredLifetimeOperation;
+
+	void HandleStoredOperation(
+		const BufferStoredLifetimeOperation& operation) override;
+	void UploadDirtyRanges(ID3D12GraphicsCommandList* commandList,
+		ResourceUploader& uploader);
 
 public:
 	FrameBufferComponent() = default;
@@ -46,6 +69,15 @@ public:
 	void RemoveComponent(const ResourceIndex& indexToRemove) override;
 
 	void SetUpdateData(const ResourceIndex& resourceIndex, void* dataAdress);
+	// Identifier can be any type with a ResourceIndex internalIndex member, such as the
+	// identifiers of a resource category. Component i is read from dataStart + i * dataStride,
+	// copy updated buffers placed next to each other are then uploaded with a single copy
+	template<typename Identifier>
+	void SetUpdateDataBatch(const Identifier* identifiers, size_t nrOfIdentifiers,
+		unsigned char* dataStart, size_t dataStride);
+	// Only the given bytes are uploaded, once to the buffer of each frame
+	void SetUpdateDataRange(const ResourceIndex& resourceIndex, void* dataAdress,
+		size_t offsetInBytes, size_t sizeInBytes);
 	void PrepareResourcesForUpdates(std::vector<D3D12_RESOURCE_BARRIER>& barriers);
 	void PerformUpdates(ID3D12GraphicsCommandList* commandList,
 		ResourceUploader& uploader);
@@ -62,33 +94,108 @@ public:
 };
 
 template<short Frames>
-inline void FrameBufferComponent<Frames>::HandleStoredOperations()
+inline void FrameBufferComponent<Frames>::HandleStoredOperation(
+	const BufferStoredLifetimeOperation& operation)
+{
+	if (operation.type == BufferLifetimeOperationType::CREATION)
+	{
+		auto& creationData = operation.creation;
+		auto identifier = this->resourceComponents[this->activeFrame].CreateBuffer(
+			creationData.nrOfElements, creationData.replacementViews);
+
+		BufferHandle handle =
+			this->resourceComponents[this->activeFrame].GetBufferHandle(identifier);
+		this->AddInitializationBarrier(handle.resource);
+	}
+	else
+	{
+		this->resourceComponents[this->activeFrame].RemoveComponent(
+			operation.removal.indexToRemove);
+	}
+}
+
+template<short Frames>
+inline void FrameBufferComponent<Frames>::UploadDirtyRanges(
+	ID3D12GraphicsCommandList* commandList, ResourceUploader& uploader)
 {
-	size_t nrToErase = 0;
-	for (auto& operation : this->storedLifetimeOperations)
+	if (dirtyRanges.size() == 0)
+		return;
+
+	std::sort(dirtyRanges.begin(), dirtyRanges.end(),
+		[](const DirtyRange& first, const DirtyRange& second)
+		{
+			const ResourceIdentifier& firstIdentifier = first.resourceIndex.allocatorIdentifier;
+			const ResourceIdentifier& secondIdentifier = second.resourceIndex.allocatorIdentifier;
+
+			if (firstIdentifier.heapChunkIndex != secondIdentifier.heapChunkIndex)
+				return firstIdentifier.heapChunkIndex < secondIdentifier.heapChunkIndex;
+			if (firstIdentifier.internalIndex != secondIdentifier.internalIndex)
+				return firstIdentifier.internalIndex < secondIdentifier.internalIndex;
+
+			return first.offset < second.offset;
+		});
+
+	std::uint64_t frameBit = std::uint64_t(1) << this->activeFrame;
+	BufferComponent& activeComponent = this->resourceComponents[this->activeFrame];
+	size_t runStart = 0;
+
+	while (runStart < dirtyRanges.size())
 	{
-		if (operation.type == BufferLifetimeOperationType::CREATION)
+		if ((dirtyRanges[runStart].pendingFrames & frameBit) == 0)
 		{
-			auto& creationData = operation.creation;
-			auto identifier = this->resourceComponents[this->activeFrame].CreateBuffer(
-				creationData.nrOfElements, creationData.replacementViews);
+			++runStart;
+			continue;
+		}
 
-			BufferHandle handle =
-				this->resourceComponents[this->activeFrame].GetBufferHandle(identifier);
-			this->AddInitializationBarrier(handle.resource);
+		const DirtyRange& first = dirtyRanges[runStart];
+		BufferHandle handle = activeComponent.GetBufferHandle(first.resourceIndex);
+		unsigned char* source = static_cast<unsigned char*>(
+			componentData.GetComponentData(first.resourceIndex)) + first.offset;
+		size_t destinationOffset = handle.startOffset + first.offset;
+		size_t size = first.size;
+		size_t runEnd = runStart + 1;
+
+		// Ranges continuing the copy in both the stored data and the same resource become a
+		// single copy, that covers overlapping ranges of one buffer and neighbouring buffers
+		for (; runEnd < dirtyRanges.size(); ++runEnd)
+		{
+			const DirtyRange& next = dirtyRanges[runEnd];
+			if ((next.pendingFrames & frameBit) == 0)
+				break;
+
+			BufferHandle nextHandle = activeComponent.GetBufferHandle(next.resourceIndex);
+			size_t nextDestinationOffset = nextHandle.startOffset + next.offset;
+			unsigned char* nextSource = static_cast<unsigned char*>(
+				componentData.GetComponentData(next.resourceIndex)) + next.offset;
+
+			if (nextHandle.resource != handle.resource ||
+				nextDestinationOffset < destinationOffset ||
+				nextDestinationOffset > destinationOffset + size ||
+				nextSource != source + (nextDestinationOffset - destinationOffset))
+			{
+				break;
+			}
+
+			size = std::max<size_t>(size,
+				nextDestinationOffset + next.size - destinationOffset);
 		}
-		else
+
+		bool uploaded = uploader.UploadBufferResourceData(handle.resource, commandList,
+			source, destinationOffset, size, bufferAlignment);
+
+		if (uploaded)
 		{
-			this->resourceComponents[this->activeFrame].RemoveComponent(
-				operation.removal.indexToRemove);
+			for (size_t i = runStart; i < runEnd; ++i)
+				dirtyRanges[i].pendingFrames &= ~frameBit;
 		}
 
-		--operation.framesLeft;
-		nrToErase += operation.framesLeft == 0 ? 1 : 0;
+		runStart = runEnd;
 	}
 
-	this->storedLifetimeOperations.erase(this->storedLifetimeOperations.begin(),
-		this->storedLifetimeOperations.begin() + nrToErase);
+	std::erase_if(dirtyRanges, [](const DirtyRange& range)
+		{
+			return range.pendingFrames == 0;
+		});
 }
 
 template<short Frames>
@@ -96,7 +203,8 @@ inline FrameBufferComponent<Frames>::FrameBufferComponent(
 	FrameBufferComponent&& other) noexcept : FrameResourceComponent<
 	BufferComponent, Frames, BufferCreationOperation>(std::move(other)),
 	bufferSize(other.bufferSize), bufferAlignment(other.bufferAlignment),
-	componentData(std::move(other.componentData))
+	updateType(other.updateType), componentData(std::move(other.componentData)),
+	dirtyRanges(std::move(other.dirtyRanges))
 {
 	other.bufferSize = 0;
 	other.bufferAlignment = 0;
@@ -112,7 +220,9 @@ inline FrameBufferComponent<Frames>& FrameBufferComponent<Frames>::operator=(
 			Frames, BufferCreationOperation>::operator=(std::move(other));
 		bufferSize = other.bufferSize;
 		bufferAlignment = other.bufferAlignment;
+		updateType = other.updateType;
 		componentData = std::move(other.componentData);
+		dirtyRanges = std::move(other.dirtyRanges);
 
 		other.bufferSize = 0;
 		other.bufferAlignment = 0;
@@ -130,6 +240,7 @@ inline void FrameBufferComponent<Frames>::Initialize(ID3D12Device* deviceToUse,
 		BufferCreationOperation>::Initialize(deviceToUse, bufferInfo, descriptorInfo);
 	bufferSize = bufferInfo.bufferInfo.elementSize;
 	bufferAlignment = bufferInfo.bufferInfo.alignment;
+	updateType = componentUpdateType;
 	if (componentUpdateType != UpdateType::INITIALISE_ONLY &&
 		componentUpdateType != UpdateType::NONE)
 	{
@@ -161,9 +272,8 @@ inline ResourceIndex FrameBufferComponent<Frames>::CreateBuffer(
 		typename FrameResourceComponent<BufferComponent, Frames,
 			BufferCreationOperation>::StoredLifetimeOperation lifetimeOperation;
 		lifetimeOperation.type = BufferLifetimeOperationType::CREATION;
-		lifetimeOperation.framesLeft = Frames - 1;
 		lifetimeOperation.creation = { nrOfElements, replacementViews };
-		this->storedLifetimeOperations.push_back(lifetimeOperation);
+		this->StoreLifetimeOperation(lifetimeOperation);
 	}
 
 	BufferHandle handle =
@@ -179,6 +289,14 @@ template<short Frames>
 inline void FrameBufferComponent<Frames>::RemoveComponent(
 	const ResourceIndex& indexToRemove)
 {
+	std::erase_if(dirtyRanges, [&indexToRemove](const DirtyRange& range)
+		{
+			return range.resourceIndex.allocatorIdentifier.heapChunkIndex ==
+				indexToRemove.allocatorIdentifier.heapChunkIndex &&
+				range.resourceIndex.allocatorIdentifier.internalIndex ==
+				indexToRemove.allocatorIdentifier.internalIndex;
+		});
+
 	componentData.RemoveComponent(indexToRemove);
 	FrameResourceComponent<BufferComponent, Frames,
 		BufferCreationOperation>::RemoveComponent(indexToRemove);
@@ -191,6 +309,65 @@ inline void FrameBufferComponent<Frames>::SetUpdateData(
 	this->componentData.UpdateComponentData(resourceIndex, dataAdress);
 }
 
+template<short Frames>
+template<typename Identifier>
+inline void FrameBufferComponent<Frames>::SetUpdateDataBatch(
+	const Identifier* identifiers, size_t nrOfIdentifiers,
+	unsigned char* dataStart, size_t dataStride)
+{
+	if (updateType != UpdateType::COPY_UPDATE)
+	{
+		for (size_t i = 0; i < nrOfIdentifiers; ++i)
+			SetUpdateData(identifiers[i].internalIndex, dataStart + i * dataStride);
+
+		return;
+	}
+
+	// Whole buffers are recorded as dirty ranges, which are merged across buffers when uploaded
+	BufferComponent& activeComponent = this->resourceComponents[this->activeFrame];
+	for (size_t i = 0; i < nrOfIdentifiers; ++i)
+	{
+		const ResourceIndex& resourceIndex = identifiers[i].internalIndex;
+		size_t size = activeComponent.GetBufferHandle(resourceIndex).nrOfElements * bufferSize;
+		std::memcpy(componentData.GetComponentData(resourceIndex),
+			dataStart + i * dataStride, size);
+
+		DirtyRange toAdd;
+		toAdd.resourceIndex = resourceIndex;
+		toAdd.offset = 0;
+		toAdd.size = size;
+		toAdd.pendingFrames = (std::uint64_t(1) << Frames) - 1;
+		dirtyRanges.push_back(toAdd);
+	}
+}
+
+template<short Frames>
+inline void FrameBufferComponent<Frames>::SetUpdateDataRange(
+	const ResourceIndex& resourceIndex, void* dataAdress, size_t offsetInBytes,
+	size_t sizeInBytes)
+{
+	if (updateType != UpdateType::COPY_UPDATE)
+		throw std::runtime_error("Ranged updates require a copy updated buffer component");
+
+	// Written without the sum so that a large offset cannot wrap around and pass the check
+	size_t size = this->resourceComponents[this->activeFrame].GetBufferHandle(
+		resourceIndex).nrOfElements * bufferSize;
+	if (sizeInBytes > size || offsetInBytes > size - sizeInBytes)
+		throw std::runtime_error("Ranged update extends past the end of the buffer");
+
+	// The stored component data is kept current, so every frame can upload from it later
+	unsigned char* storedData = static_cast<unsigned char*>(
+		componentData.GetComponentData(resourceIndex));
+	std::memcpy(storedData + offsetInBytes, dataAdress, sizeInBytes);
+
+	DirtyRange toAdd;
+	toAdd.resourceIndex = resourceIndex;
+	toAdd.offset = offsetInBytes;
+	toAdd.size = sizeInBytes;
+	toAdd.pendingFrames = (std::uint64_t(1) << Frames) - 1;
+	dirtyRanges.push_back(toAdd);
+}
+
 template<short Frames>
 inline void FrameBufferComponent<Frames>::PrepareResourcesForUpdates(
 	std::vector<D3D12_RESOURCE_BARRIER>& barriers)
@@ -205,6 +382,7 @@ inline void FrameBufferComponent<Frames>::PerformUpdates(
 {
 	this->componentData.UpdateComponentResources(commandList, uploader,
 		this->resourceComponents[this->activeFrame], bufferAlignment);
+	UploadDirtyRanges(commandList, uploader);
 }
 
 template<short Frames>
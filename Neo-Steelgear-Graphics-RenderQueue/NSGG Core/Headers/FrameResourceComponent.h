@@ -27,29 +27,24 @@ protected:
 
 	struct StoredLifetimeOperation
 	{
-		LifetimeOperationType type;
-		std::uint8_t framesLeft;
-
-		union
-		{
-			CreationOperation creation;
-			struct RemovalOperation
-			{
-				ResourceIndex indexToRemove;
-			} removal;
-		};
-
-		StoredLifetimeOperation()
+		LifetimeOperationType type = LifetimeOperationType::CREATION;
+		CreationOperation creation = CreationOperation();
+		struct RemovalOperation
 		{
-			ZeroMemory(this, sizeof(StoredLifetimeOperation));
-		}
+			ResourceIndex indexToRemove;
+		} removal;
 	};
 
-	std::vector<StoredLifetimeOperation> storedLifetimeOperations;
+	// One bucket per frame slot, holding the operations recorded while that slot was active.
+	// A bucket is replayed on every other slot as it becomes active and is reused once its
+	// own slot comes around again, so the vectors keep their capacity between frames.
+	std::array<std::vector<StoredLifetimeOperation>, Frames> storedLifetimeOperations;
 	std::vector<D3D12_RESOURCE_BARRIER> initializationBarriers;
 
 	void AddInitializationBarrier(ID3D12Resource* resource);
-	virtual void HandleStoredOperations() = 0;
+	void StoreLifetimeOperation(const StoredLifetimeOperation& operation);
+	void HandleStoredOperations();
+	virtual void HandleStoredOperation(const StoredLifetimeOperation& operation) = 0;
 
 public:
 	FrameResourceComponent() = default;
@@ -141,9 +136,8 @@ FrameResourceComponent<Component, Frames, CreationOperation>::RemoveComponent(
 	{
 		StoredLifetimeOperation toStore;
 		toStore.type = LifetimeOperationType::REMOVAL;
-		toStore.framesLeft = Frames - 1;
 		toStore.removal.indexToRemove = indexToRemove;
-		storedLifetimeOperations.push_back(toStore);
+		StoreLifetimeOperation(toStore);
 	}
 }
 
@@ -212,4 +206,29 @@ FrameResourceComponent<Component, Frames, CreationOperation>::SwapFrame()
 {
 	FrameBased<Frames>::SwapFrame();
 	HandleStoredOperations();
+}
+
+template<typename Component, FrameType Frames, typename CreationOperation>
+inline void 
+FrameResourceComponent<Component, Frames, CreationOperation>::StoreLifetimeOperation(
+	const StoredLifetimeOperation& operation)
+{
+	storedLifetimeOperations[this->activeFrame].push_back(operation);
+}
+
+template<typename Component, FrameType Frames, typename CreationOperation>
+inline void 
+FrameResourceComponent<Component, Frames, CreationOperation>::HandleStoredOperations()
+{
+	// The bucket of the new active frame was recorded Frames swaps ago and has
+	// already been replayed on every other frame, so it can be recycled
+	storedLifetimeOperations[this->activeFrame].clear();
+
+	// Replay the remaining buckets oldest first so identifiers match across frames
+	for (FrameType offset = 1; offset < Frames; ++offset)
+	{
+		FrameType frame = static_cast<FrameType>((this->activeFrame + offset) % Frames);
+		for (const auto& operation : storedLifetimeOperations[frame])
+			HandleStoredOperation(operation);
+	}
 }
\ No newline at end of file
@@ -33,7 +33,11 @@ private:
 	DXGI_FORMAT textureFormat = DXGI_FORMAT_UNKNOWN;
 	Texture2DComponentData componentData;
 
-	void HandleStoredOperations() override;
+	typedef typename FrameResourceComponent<Texture2DComponent, Frames,
+		Texture2DCreationOperation>::StoredLifetimeOperation Texture2DStoredLifetimeOperation;
+
+	void HandleStoredOperation(
+		const Texture2DStoredLifetimeOperation& operation) override;
 
 public:
 	FrameTexture2DComponent() = default;
@@ -74,37 +78,28 @@ public:
 };
 
 template<FrameType Frames>
-inline void FrameTexture2DComponent<Frames>::HandleStoredOperations()
+inline void FrameTexture2DComponent<Frames>::HandleStoredOperation(
+	const Texture2DStoredLifetimeOperation& operation)
 {
-	size_t nrToErase = 0;
-	for (auto& operation : this->storedLifetimeOperations)
+	if (operation.type == Texture2DLifetimeOperationType::CREATION)
 	{
-		if (operation.type == Texture2DLifetimeOperationType::CREATION)
-		{
-			Texture2DCreationOperation creationInfo = operation.creation;
-			auto identifier = this->resourceComponents[this->activeFrame].CreateTexture(
-				creationInfo.width, creationInfo.height, 
-				creationInfo.arraySize, creationInfo.mipLevels,
-				creationInfo.sampleCount, creationInfo.sampleQuality,
-				creationInfo.clearValue.has_value() ? &(*creationInfo.clearValue) : nullptr,
-				creationInfo.replacementViews);
-
-			TextureHandle handle =
-				this->resourceComponents[this->activeFrame].GetTextureHandle(identifier);
-			this->AddInitializationBarrier(handle.resource);
-		}
-		else
-		{
-			this->resourceComponents[this->activeFrame].RemoveComponent(
-				operation.removal.indexToRemove);
-		}
-
-		--operation.framesLeft;
-		nrToErase += operation.framesLeft == 0 ? 1 : 0;
+		Texture2DCreationOperation creationInfo = operation.creation;
+		auto identifier = this->resourceComponents[this->activeFrame].CreateTexture(
+			creationInfo.width, creationInfo.height, 
+			creationInfo.arraySize, creationInfo.mipLevels,
+			creationInfo.sampleCount, creationInfo.sampleQuality,
+			creationInfo.clearValue.has_value() ? &(*creationInfo.clearValue) : nullptr,
+			creationInfo.replacementViews);
+
+		TextureHandle handle =
+			this->resourceComponents[this->activeFrame].GetTextureHandle(identifier);
+		this->AddInitializationBarrier(handle.resource);
+	}
+	else
+	{
+		this->resourceComponents[this->activeFrame].RemoveComponent(
+			operation.removal.indexToRemove);
 	}
-
-	this->storedLifetimeOperations.erase(this->storedLifetimeOperations.begin(),
-		this->storedLifetimeOperations.begin() + nrToErase);
 }
 
 template<FrameType Frames>
@@ -187,7 +182,6 @@ inline ResourceIndex FrameTexture2DComponent<Frames>::CreateTexture(
 		typename FrameResourceComponent<Texture2DComponent, Frames,
 			Texture2DCreationOperation>::StoredLifetimeOperation lifetimeOperation;
 		lifetimeOperation.type = Texture2DLifetimeOperationType::CREATION;
-		lifetimeOperation.framesLeft = Frames - 1;
 		lifetimeOperation.creation.width = width; 
 		lifetimeOperation.creation.height = height;
 		lifetimeOperation.creation.arraySize = arraySize;
@@ -198,7 +192,7 @@ inline ResourceIndex FrameTexture2DComponent<Frames>::CreateTexture(
 			(clearValue == nullptr ? std::nullopt :
 				std::make_optional(*clearValue));
 		lifetimeOperation.creation.replacementViews = replacementViews;
-		this->storedLifetimeOperations.push_back(lifetimeOperation);
+		this->StoreLifetimeOperation(lifetimeOperation);
 	}
 
 	TextureHandle handle = 
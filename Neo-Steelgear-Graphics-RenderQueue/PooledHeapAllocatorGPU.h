@@ -0,0 +1,133 @@
+#pragma once
+
+#include <vector>
+#include <stdexcept>
+
+#include <d3d12.h>
+
+#include <HeapAllocatorGPU.h>
+
+// Places chunks inside larger shared heaps, OffsetAllocator decides where in a heap each chunk goes
+template<typename OffsetAllocator>
+class PooledHeapAllocatorGPU : public HeapAllocatorGPU
+{
+private:
+	struct PooledHeap
+	{
+		ID3D12Heap* heap = nullptr;
+		D3D12_HEAP_TYPE heapType = D3D12_HEAP_TYPE_DEFAULT;
+		D3D12_HEAP_FLAGS heapFlags = D3D12_HEAP_FLAG_NONE;
+		OffsetAllocator allocator;
+	};
+
+	std::vector<PooledHeap> heaps;
+	size_t heapSize = 0;
+	size_t chunkAlignment = 0;
+
+	HeapChunk AllocateFromHeap(PooledHeap& pooledHeap, size_t size);
+	void ReleaseHeaps();
+
+public:
+	PooledHeapAllocatorGPU() = default;
+	virtual ~PooledHeapAllocatorGPU();
+	PooledHeapAllocatorGPU(const PooledHeapAllocatorGPU& other) = delete;
+	PooledHeapAllocatorGPU& operator=(const PooledHeapAllocatorGPU& other) = delete;
+	PooledHeapAllocatorGPU(PooledHeapAllocatorGPU&& other) = default;
+	PooledHeapAllocatorGPU& operator=(PooledHeapAllocatorGPU&& other) = default;
+
+	// Chunks larger than the heap size get a heap of their own
+	void Initialize(ID3D12Device* deviceToUse, size_t heapSizeToUse,
+		size_t chunkAlignmentToUse);
+
+	virtual HeapChunk AllocateChunk(size_t minimumRequiredSize,
+		D3D12_HEAP_TYPE requiredType, D3D12_HEAP_FLAGS requiredFlags) override;
+	virtual void DeallocateChunk(HeapChunk& chunk) override;
+};
+
+template<typename OffsetAllocator>
+inline HeapChunk PooledHeapAllocatorGPU<OffsetAllocator>::AllocateFromHeap(
+	PooledHeap& pooledHeap, size_t size)
+{
+	HeapChunk toReturn;
+	toReturn.heapType = pooledHeap.heapType;
+	toReturn.heapFlags = pooledHeap.heapFlags;
+	toReturn.startOffset = pooledHeap.allocator.Allocate(size);
+
+	if (toReturn.startOffset != size_t(-1))
+	{
+		toReturn.heap = pooledHeap.heap;
+		toReturn.endOffset = toReturn.startOffset +
+			OffsetAllocator::GetAllocationSize(size, chunkAlignment);
+	}
+
+	return toReturn;
+}
+
+template<typename OffsetAllocator>
+inline void PooledHeapAllocatorGPU<OffsetAllocator>::ReleaseHeaps()
+{
+	for (PooledHeap& pooledHeap : heaps)
+		pooledHeap.heap->Release();
+
+	heaps.clear();
+}
+
+template<typename OffsetAllocator>
+inline PooledHeapAllocatorGPU<OffsetAllocator>::~PooledHeapAllocatorGPU()
+{
+	ReleaseHeaps();
+}
+
+template<typename OffsetAllocator>
+inline void PooledHeapAllocatorGPU<OffsetAllocator>::Initialize(
+	ID3D12Device* deviceToUse, size_t heapSizeToUse, size_t chunkAlignmentToUse)
+{
+	ReleaseHeaps();
+	device = deviceToUse;
+	heapSize = heapSizeToUse;
+	chunkAlignment = chunkAlignmentToUse;
+}
+
+template<typename OffsetAllocator>
+inline HeapChunk PooledHeapAllocatorGPU<OffsetAllocator>::AllocateChunk(
+	size_t minimumRequiredSize, D3D12_HEAP_TYPE requiredType,
+	D3D12_HEAP_FLAGS requiredFlags)
+{
+	for (PooledHeap& pooledHeap : heaps)
+	{
+		if (pooledHeap.heapType != requiredType || pooledHeap.heapFlags != requiredFlags)
+			continue;
+
+		HeapChunk toReturn = AllocateFromHeap(pooledHeap, minimumRequiredSize);
+		if (toReturn.heap != nullptr)
+			return toReturn;
+	}
+
+	size_t sizeOfNewHeap = OffsetAllocator::GetAllocationSize(
+		heapSize > minimumRequiredSize ? heapSize : minimumRequiredSize, chunkAlignment);
+
+	PooledHeap toAdd;
+	toAdd.heap = CreateHeap(sizeOfNewHeap, requiredType, requiredFlags);
+	toAdd.heapType = requiredType;
+	toAdd.heapFlags = requiredFlags;
+	toAdd.allocator.Initialize(sizeOfNewHeap, chunkAlignment);
+	heaps.push_back(std::move(toAdd));
+
+	return AllocateFromHeap(heaps.back(), minimumRequiredSize);
+}
+
+template<typename OffsetAllocator>
+inline void PooledHeapAllocatorGPU<OffsetAllocator>::DeallocateChunk(
+	HeapChunk& chunk)
+{
+	for (PooledHeap& pooledHeap : heaps)
+	{
+		if (pooledHeap.heap == chunk.heap)
+		{
+			pooledHeap.allocator.Deallocate(chunk.startOffset);
+			return;
+		}
+	}
+
+	throw std::runtime_error("Attempting to deallocate a chunk that was not allocated from the pooled heap allocator");
+}
\ No newline at end of file
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <vector>
+#include <utility>
 #include <unordered_map>
+#include <stdexcept>
 
 #include <d3d12.h>
 
@@ -35,11 +37,20 @@ private:
 	};
 
 	std::vector<QueueResource> transientResources;
-	std::unordered_map<CategoryIdentifier, QueueResource> componentResources;
+	std::vector<std::pair<CategoryIdentifier, QueueResource>> componentResources;
+	std::vector<size_t> componentResourceIndices; // Indexed by dense category index
+
+	// Textures of a category requested individually, so only the textures a job touches get barriers
+	std::vector<std::pair<CategoryResourceIdentifier, QueueResource>> categoryTextureResources;
+	std::unordered_map<CategoryResourceIdentifier, size_t> categoryTextureResourceIndices;
+	std::vector<bool> requestedPerTexture; // Indexed by dense category index
+	std::vector<CategoryIdentifier> usedCategories;
 
 	std::vector<EnqueuedJob<Frames>> jobs;
+	std::vector<FrameResourceBarrier> neededBarriers;
 
-	void HandleRequest(QueueResource& resource, D3D12_RESOURCE_STATES neededState);
+	void HandleRequest(QueueResource& resource, D3D12_RESOURCE_STATES neededState,
+		const SubresourceRange& range = SubresourceRange());
 
 	void AddPostExecutionCategoryBarriers();
 
@@ -56,9 +67,13 @@ public:
 	TransientResourceIndex CreateTransientResource(D3D12_RESOURCE_STATES initialState);
 
 	void RequestTransientResource(const TransientResourceIndex& index,
-		D3D12_RESOURCE_STATES neededState);
+		D3D12_RESOURCE_STATES neededState,
+		const SubresourceRange& range = SubresourceRange());
 	void RequestCategoryResource(const CategoryIdentifier& identifier,
 		D3D12_RESOURCE_STATES neededState);
+	void RequestCategoryResource(const CategoryResourceIdentifier& identifier,
+		D3D12_RESOURCE_STATES neededState,
+		const SubresourceRange& range = SubresourceRange());
 
 	void AddJobToQueue(QueueJob<Frames>* job);
 	void FinalizeQueue(TransientResourceIndex endTextureIndex);
@@ -67,17 +82,19 @@ public:
 
 template<FrameType Frames>
 void QueueContext<Frames>::HandleRequest(
-	QueueResource& resource, D3D12_RESOURCE_STATES neededState)
+	QueueResource& resource, D3D12_RESOURCE_STATES neededState,
+	const SubresourceRange& range)
 {
-	std::optional<FrameResourceBarrier> neededBarrier =
-		resource.resource.UpdateState(neededState);
+	neededBarriers.clear();
+	bool mergeable = resource.resource.UpdateState(neededState, neededBarriers, range);
 
-	if (neededBarrier.has_value())
+	if (neededBarriers.size() != 0)
 	{
-		resource.barrierIndexOfLastBarrier = jobs.back().AddBarrier(std::move(neededBarrier.value()));
+		for (FrameResourceBarrier& barrier : neededBarriers)
+			resource.barrierIndexOfLastBarrier = jobs.back().AddBarrier(std::move(barrier));
 		resource.jobIndexOfLastStateChange = jobs.size() - 1;
 	}
-	else if (resource.jobIndexOfLastStateChange != size_t(-1))
+	else if (mergeable && resource.jobIndexOfLastStateChange != size_t(-1))
 	{
 		auto& lastJob = jobs[resource.jobIndexOfLastStateChange];
 		FrameResourceBarrier& lastBarrier = 
@@ -115,6 +132,19 @@ inline void QueueContext<Frames>::AddPostExecutionCategoryBarriers()
 			renderQueue->postExecutionBarriers.push_back(std::move(toAdd));
 		}
 	}
+
+	for (const auto& texturePair : categoryTextureResources)
+	{
+		bool transitionNeeded =
+			texturePair.second.jobIndexOfLastStateChange != size_t(-1);
+		transitionNeeded |= texturePair.second.resource.IsInWriteState();
+
+		if (transitionNeeded)
+		{
+			texturePair.second.resource.AddTransitionsToState(
+				D3D12_RESOURCE_STATE_COMMON, renderQueue->postExecutionBarriers);
+		}
+	}
 }
 
 template<FrameType Frames>
@@ -131,7 +161,8 @@ inline TransientResourceIndex QueueContext<Frames>::CreateTransientResource(
 	FrameResourceIdentifier identifier(transientResources.size());
 
 	QueueResource queueResource(identifier);
-	queueResource.resource.UpdateState(initialState);
+	neededBarriers.clear();
+	queueResource.resource.UpdateState(initialState, neededBarriers);
 	transientResources.push_back(std::move(queueResource));
 
 	return transientResources.size() - 1;
@@ -139,21 +170,73 @@ inline TransientResourceIndex QueueContext<Frames>::CreateTransientResource(
 
 template<FrameType Frames>
 inline void QueueContext<Frames>::RequestTransientResource(
-	const TransientResourceIndex& index, D3D12_RESOURCE_STATES neededState)
+	const TransientResourceIndex& index, D3D12_RESOURCE_STATES neededState,
+	const SubresourceRange& range)
 {
-	HandleRequest(transientResources[index], neededState);
+	HandleRequest(transientResources[index], neededState, range);
 }
 
 template<FrameType Frames>
 inline void QueueContext<Frames>::RequestCategoryResource(
 	const CategoryIdentifier& identifier, D3D12_RESOURCE_STATES neededState)
 {
-	if (componentResources.find(identifier) == componentResources.end())
+	if (componentResourceIndices.size() <= identifier.denseIndex)
+		componentResourceIndices.resize(identifier.denseIndex + 1, size_t(-1));
+
+	if (requestedPerTexture.size() > identifier.denseIndex &&
+		requestedPerTexture[identifier.denseIndex] == true)
+	{
+		throw std::runtime_error("Category already requested per texture in this queue");
+	}
+
+	size_t& resourceIndex = componentResourceIndices[identifier.denseIndex];
+	if (resourceIndex == size_t(-1))
 	{
-		componentResources.emplace(identifier, identifier);
+		resourceIndex = componentResources.size();
+		componentResources.emplace_back(identifier, identifier);
+		usedCategories.push_back(identifier);
 	}
 
-	HandleRequest(componentResources.at(identifier), neededState);
+	HandleRequest(componentResources[resourceIndex].second, neededState);
+}
+
+template<FrameType Frames>
+inline void QueueContext<Frames>::RequestCategoryResource(
+	const CategoryResourceIdentifier& identifier, D3D12_RESOURCE_STATES neededState,
+	const SubresourceRange& range)
+{
+	const CategoryIdentifier& category = identifier.categoryIdentifier;
+
+	if (category.type == CategoryType::BUFFER)
+	{
+		// Buffers in a category share a single resource
+		RequestCategoryResource(category, neededState);
+		return;
+	}
+
+	if (componentResourceIndices.size() > category.denseIndex &&
+		componentResourceIndices[category.denseIndex] != size_t(-1))
+	{
+		throw std::runtime_error("Category already requested as a whole in this queue");
+	}
+
+	if (requestedPerTexture.size() <= category.denseIndex)
+		requestedPerTexture.resize(category.denseIndex + 1, false);
+
+	if (requestedPerTexture[category.denseIndex] == false)
+	{
+		requestedPerTexture[category.denseIndex] = true;
+		usedCategories.push_back(category);
+	}
+
+	auto result = categoryTextureResourceIndices.try_emplace(identifier,
+		categoryTextureResources.size());
+
+	if (result.second == true)
+		categoryTextureResources.emplace_back(identifier, identifier);
+
+	HandleRequest(categoryTextureResources[result.first->second].second,
+		neededState, range);
 }
 
 template<FrameType Frames>
@@ -180,16 +263,10 @@ inline void QueueContext<Frames>::FinalizeQueue(
 
 	renderQueue->jobs = std::move(jobs);
 	renderQueue->endTextureIndex = endTextureIndex;
+	renderQueue->usedCategories = usedCategories;
 
-	std::optional<FrameResourceBarrier> endTextureTransition =
-		transientResources[endTextureIndex].resource.UpdateState(
-			D3D12_RESOURCE_STATE_COPY_SOURCE);
-
-	if (endTextureTransition.has_value() == true)
-	{
-		renderQueue->postExecutionBarriers.push_back(
-			std::move(endTextureTransition.value()));
-	}
+	transientResources[endTextureIndex].resource.UpdateState(
+		D3D12_RESOURCE_STATE_COPY_SOURCE, renderQueue->postExecutionBarriers);
 
 	AddPostExecutionCategoryBarriers();
 }
@@ -198,11 +275,19 @@ template<FrameType Frames>
 inline void QueueContext<Frames>::ClearQueue()
 {
 	transientResources.clear();
+	for (const auto& componentPair : componentResources)
+		componentResourceIndices[componentPair.first.denseIndex] = size_t(-1);
 	componentResources.clear();
+	for (const auto& texturePair : categoryTextureResources)
+		requestedPerTexture[texturePair.first.categoryIdentifier.denseIndex] = false;
+	categoryTextureResources.clear();
+	categoryTextureResourceIndices.clear();
+	usedCategories.clear();
 	jobs.clear();
 
 	renderQueue->transientResources.clear();
 	renderQueue->jobs.clear();
 	renderQueue->postExecutionBarriers.clear();
+	renderQueue->usedCategories.clear();
 	renderQueue->endTextureIndex = TransientResourceIndex(-1);
 }
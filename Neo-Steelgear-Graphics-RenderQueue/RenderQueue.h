@@ -14,6 +14,7 @@
 #include "RenderQueueTimerCPU.h"
 #include "RenderQueueTimerGPU.h"
 #include "ImguiContext.h"
+#include "CategoryIdentifiers.h"
 
 template<FrameType Frames>
 class RenderQueue
@@ -30,6 +31,7 @@ private:
 
 	std::vector<EnqueuedJob<Frames>> jobs;
 	std::vector<FrameResourceBarrier> postExecutionBarriers;
+	std::vector<CategoryIdentifier> usedCategories;
 
 	TransientResourceIndex endTextureIndex = TransientResourceIndex(-1);
 
@@ -72,6 +74,7 @@ public:
 	FrameSetupContext& GetFrameSetupContext();
 	TransientResourceIndex GetEndTextureIndex() const;
 	const std::vector<FrameResourceBarrier>& GetPostExecutionBarriers() const;
+	const std::vector<CategoryIdentifier>& GetUsedCategories() const;
 };
 
 template<FrameType Frames>
@@ -189,12 +192,13 @@ void RenderQueue<Frames>::SetupTransientResources(
 	}
 
 	setupContext.CreateTransientDescriptors(blackboard);
-	blackboard.SetLocalFrameMemoryRequirement(setupContext.totalLocalMemoryNeeded);
 
-	for (const auto& localDesc : setupContext.localResourceDescs)
+	for (size_t i = 0; i < setupContext.localResources.Size(); ++i)
 	{
-		blackboard.CreateLocalResource(localDesc);
+		blackboard.CreateLocalResource(setupContext.localResources[i]);
 	}
+
+	blackboard.SetLocalFrameMemoryRequirement(setupContext.totalLocalMemoryNeeded);
 }
 
 template<FrameType Frames>
@@ -337,3 +341,10 @@ RenderQueue<Frames>::GetPostExecutionBarriers() const
 {
 	return postExecutionBarriers;
 }
+
+template<FrameType Frames>
+const std::vector<CategoryIdentifier>&
+RenderQueue<Frames>::GetUsedCategories() const
+{
+	return usedCategories;
+}
\ No newline at end of file
@@ -40,6 +40,10 @@ struct BlackboardSettings
 struct DescriptorHeapSettings
 {
 	size_t startDescriptorsPerFrame = 1000;
+	size_t startPersistentDescriptors = 1000;
+	bool bindless = false;
+	size_t startBindlessDescriptors = 10000;
+	DescriptorHeapSizingInfo sizingInfo;
 };
 
 struct InformationSettings
@@ -92,6 +96,7 @@ private:
 	FrameObject<ManagedFence, Frames> jobsDoneFence;
 
 	FrameObject<ManagedCommandAllocator, Frames> updateAllocator;
+	std::vector<FrameObject<ManagedCommandAllocator, Frames>> updateWorkerAllocators;
 	FrameObject<ManagedCommandAllocator, Frames> mainAllocator;
 
 	RenderQueueTimerCPU cpuTimer;
@@ -144,6 +149,7 @@ public:
 
 	const FrameTimesCPU& GetLastFrameTimes();
 	const FrameTimesGPU& GetLastCycleFrameTimes();
+	DescriptorHeapStatistics GetDescriptorHeapStatistics() const;
 	void AddImguiFunction(std::function<void(ImguiContext&)>& function);
 };
 
@@ -295,16 +301,33 @@ inline void Renderer<Frames>::InitializeAndUpdateCategoryResources()
 	static std::vector<D3D12_RESOURCE_BARRIER> initBarriers;
 	initBarriers.clear();
 
+	static std::vector<ID3D12GraphicsCommandList*> updateLists;
+	updateLists.clear();
+	updateLists.push_back(updateAllocator.Active().ActiveList());
+	for (auto& allocator : updateWorkerAllocators)
+		updateLists.push_back(allocator.Active().ActiveList());
+
 	blackboard.GetInitializeBarriers(initBarriers);
-	gpuTimer.MarkCopyStart(updateAllocator.Active().ActiveList());
-	updateAllocator.Active().ActiveList()->ResourceBarrier(initBarriers.size(),
+	gpuTimer.MarkCopyStart(updateLists.front());
+	updateLists.front()->ResourceBarrier(initBarriers.size(),
 		initBarriers.data());
-	resourceCategories.ActivateNewCategories(updateAllocator.Active().ActiveList());
-	resourceCategories.UpdateCategories(updateAllocator.Active().ActiveList());
-	gpuTimer.MarkCopyEnd(updateAllocator.Active().ActiveList());
+	resourceCategories.MarkCategoriesUsed(renderQueue.GetUsedCategories());
+	resourceCategories.ActivateNewCategories(updateLists.front());
+	resourceCategories.UpdateCategories(updateLists);
+	gpuTimer.MarkCopyEnd(updateLists.back());
 
+	static std::vector<ID3D12CommandList*> listsToExecute;
+	listsToExecute.clear();
 	updateAllocator.Active().FinishActiveList();
-	updateAllocator.Active().ExecuteCommands(copyQueue);
+	updateAllocator.Active().GatherCommandsForExecution(listsToExecute);
+	for (auto& allocator : updateWorkerAllocators)
+	{
+		allocator.Active().FinishActiveList();
+		allocator.Active().GatherCommandsForExecution(listsToExecute);
+	}
+
+	copyQueue->ExecuteCommandLists(static_cast<UINT>(listsToExecute.size()),
+		listsToExecute.data());
 	updateFence.Active().Signal(copyQueue);
 	updateFence.Active().WaitGPU(directQueue);
 	cpuTimer.MarkInitializationAndUpdate(initAndUpdateStartPoint);
@@ -436,9 +459,21 @@ inline void Renderer<Frames>::Initialize(const RenderSettings& settings)
 		settings.blackboard.transientAllocatorMemoryInfo);
 
 	descriptorHeap.Initialize(device.GetDevice(),
-		settings.descriptorHeap.startDescriptorsPerFrame);
+		settings.descriptorHeap.startDescriptorsPerFrame,
+		settings.descriptorHeap.startPersistentDescriptors,
+		settings.descriptorHeap.bindless ?
+		settings.descriptorHeap.startBindlessDescriptors : 0,
+		settings.descriptorHeap.sizingInfo);
 	resourceCategories.Initialize(device.GetDevice(),
-		settings.resourceCategories);
+		settings.resourceCategories,
+		settings.descriptorHeap.bindless ? &descriptorHeap : nullptr);
+	updateWorkerAllocators = std::vector<FrameObject<ManagedCommandAllocator, Frames>>(
+		resourceCategories.GetNrOfUpdateThreads() - 1);
+	for (auto& allocator : updateWorkerAllocators)
+	{
+		allocator.Initialize(&ManagedCommandAllocator::Initialize,
+			device.GetDevice(), D3D12_COMMAND_LIST_TYPE_COPY);
+	}
 	//workQueue = settings.threading.workQueueToUse;
 
 	cpuTimer.SetActive(settings.information.performTimingsCPU);
@@ -516,6 +551,8 @@ inline void Renderer<Frames>::WaitForAvailableFrame()
 	updateFence.SwapFrame();
 	jobsDoneFence.SwapFrame();
 	updateAllocator.SwapFrame();
+	for (auto& allocator : updateWorkerAllocators)
+		allocator.SwapFrame();
 	mainAllocator.SwapFrame();
 
 	descriptorHeap.SwapFrame();
@@ -525,6 +562,8 @@ inline void Renderer<Frames>::WaitForAvailableFrame()
 
 	mainAllocator.Active().Reset();
 	updateAllocator.Active().Reset();
+	for (auto& allocator : updateWorkerAllocators)
+		allocator.Active().Reset();
 	gpuTimer.ResolveQueries(mainAllocator.Active().ActiveList(),
 		updateAllocator.Active().ActiveList());
 }
@@ -549,6 +588,7 @@ inline void Renderer<Frames>::Render(const entt::registry& registry)
 	PrepareAndSetupFrame(registry);
 	InitializeAndUpdateCategoryResources();
 	DiscardAndClearTransientResources();
+	resourceCategories.UpdateBindlessDescriptors(); // Resources created while preparing the frame
 	descriptorHeap.UploadCurrentFrameHeap();
 	ExecuteRenderQueueJobs();
 	PrepareBackbuffer();
@@ -574,6 +614,12 @@ inline const FrameTimesGPU& Renderer<Frames>::GetLastCycleFrameTimes()
 	return gpuTimer.GetPreviousFrameIterationTimes();
 }
 
+template<FrameType Frames>
+inline DescriptorHeapStatistics Renderer<Frames>::GetDescriptorHeapStatistics() const
+{
+	return descriptorHeap.GetStatistics();
+}
+
 template<FrameType Frames>
 inline void Renderer<Frames>::AddImguiFunction(std::function<void(ImguiContext&)>& function)
 {
@@ -0,0 +1,299 @@
+#include "ResidencyManager.h"
+
+#include <stdexcept>
+
+void ResidencyManager::Unlink(size_t setIndex)
+{
+	ResidencySet& set = sets[setIndex];
+
+	if (set.previous != size_t(-1))
+		sets[set.previous].next = set.next;
+	else
+		leastRecentlyUsed = set.next;
+
+	if (set.next != size_t(-1))
+		sets[set.next].previous = set.previous;
+	else
+		mostRecentlyUsed = set.previous;
+
+	set.previous = size_t(-1);
+	set.next = size_t(-1);
+}
+
+void ResidencyManager::LinkAsMostRecentlyUsed(size_t setIndex)
+{
+	ResidencySet& set = sets[setIndex];
+	set.previous = mostRecentlyUsed;
+	set.next = size_t(-1);
+
+	if (mostRecentlyUsed != size_t(-1))
+		sets[mostRecentlyUsed].next = setIndex;
+	else
+		leastRecentlyUsed = setIndex;
+
+	mostRecentlyUsed = setIndex;
+}
+
+void ResidencyManager::MakeResident(size_t setIndex)
+{
+	ResidencySet& set = sets[setIndex];
+	pageables.clear();
+
+	for (TrackedHeap& trackedHeap : set.heaps)
+	{
+		SharedHeap& sharedHeap = sharedHeaps.at(trackedHeap.heap);
+
+		if (sharedHeap.nrOfResidentSets++ == 0)
+		{
+			pageables.push_back(trackedHeap.heap);
+			residentSize += sharedHeap.size;
+		}
+	}
+
+	SubmitMakeResident();
+	set.resident = true;
+}
+
+void ResidencyManager::Evict(size_t setIndex)
+{
+	ResidencySet& set = sets[setIndex];
+
+	for (TrackedHeap& trackedHeap : set.heaps)
+	{
+		SharedHeap& sharedHeap = sharedHeaps.at(trackedHeap.heap);
+
+		if (--sharedHeap.nrOfResidentSets == 0)
+		{
+			pageables.push_back(trackedHeap.heap);
+			residentSize -= sharedHeap.size;
+		}
+	}
+
+	Unlink(setIndex);
+	set.resident = false;
+}
+
+void ResidencyManager::SubmitMakeResident()
+{
+	if (pageables.size() == 0)
+		return;
+
+	if (backend != nullptr)
+	{
+		backend->MakeResident(pageables.data(), static_cast<UINT>(pageables.size()));
+	}
+	else
+	{
+		HRESULT hr = device->MakeResident(static_cast<UINT>(pageables.size()),
+			pageables.data());
+
+		if (FAILED(hr))
+			throw std::runtime_error("Could not make residency set resident");
+	}
+}
+
+void ResidencyManager::SubmitEvict()
+{
+	if (pageables.size() == 0)
+		return;
+
+	if (backend != nullptr)
+	{
+		backend->Evict(pageables.data(), static_cast<UINT>(pageables.size()));
+	}
+	else
+	{
+		HRESULT hr = device->Evict(static_cast<UINT>(pageables.size()),
+			pageables.data());
+
+		if (FAILED(hr))
+			throw std::runtime_error("Could not evict residency sets");
+	}
+}
+
+void ResidencyManager::Initialize(ID3D12Device* deviceToUse,
+	size_t budgetInBytes, std::uint8_t nrOfFramesInFlight,
+	ResidencyBackend* backendToUse)
+{
+	device = deviceToUse;
+	budget = budgetInBytes;
+	framesInFlight = nrOfFramesInFlight;
+	backend = backendToUse;
+}
+
+size_t ResidencyManager::CreateResidencySet()
+{
+	ResidencySet toAdd;
+	toAdd.lastUsedFrame = currentFrame;
+	sets.push_back(std::move(toAdd));
+	LinkAsMostRecentlyUsed(sets.size() - 1);
+
+	return sets.size() - 1;
+}
+
+void ResidencyManager::AddHeap(size_t setIndex, ID3D12Heap* heap, size_t heapSize)
+{
+	// New heaps are resident, and a set that allocates is about to be used
+	MarkUsed(setIndex);
+	ResidencySet& set = sets[setIndex];
+
+	for (TrackedHeap& trackedHeap : set.heaps)
+	{
+		if (trackedHeap.heap == heap)
+		{
+			++trackedHeap.nrOfChunks;
+			return;
+		}
+	}
+
+	SharedHeap& sharedHeap = sharedHeaps[heap];
+
+	if (sharedHeap.nrOfSets == 0)
+	{
+		sharedHeap.size = heapSize;
+		residentSize += heapSize;
+	}
+	else if (sharedHeap.nrOfResidentSets == 0)
+	{
+		// A heap only used by evicted sets was evicted with them and must be brought back
+		pageables.clear();
+		pageables.push_back(heap);
+		SubmitMakeResident();
+		residentSize += sharedHeap.size;
+	}
+
+	set.heaps.push_back({ heap, 1 });
+	++sharedHeap.nrOfSets;
+	++sharedHeap.nrOfResidentSets;
+}
+
+void ResidencyManager::RemoveHeap(size_t setIndex, ID3D12Heap* heap)
+{
+	// The heap is handed back to its allocator, which may give it out again expecting it to be resident
+	if (sets[setIndex].resident == false)
+		MarkUsed(setIndex);
+
+	ResidencySet& set = sets[setIndex];
+
+	for (size_t i = 0; i < set.heaps.size(); ++i)
+	{
+		if (set.heaps[i].heap == heap)
+		{
+			if (--set.heaps[i].nrOfChunks != 0)
+				return;
+
+			set.heaps[i] = set.heaps.back();
+			set.heaps.pop_back();
+			auto sharedHeap = sharedHeaps.find(heap);
+			--sharedHeap->second.nrOfResidentSets;
+
+			if (--sharedHeap->second.nrOfSets == 0)
+			{
+				// No longer tracked, it stays resident with its allocator
+				residentSize -= sharedHeap->second.size;
+				sharedHeaps.erase(sharedHeap);
+			}
+			else if (sharedHeap->second.nrOfResidentSets == 0)
+			{
+				// Only evicted sets are left using the heap
+				pageables.clear();
+				pageables.push_back(heap);
+				SubmitEvict();
+				residentSize -= sharedHeap->second.size;
+			}
+
+			return;
+		}
+	}
+
+	throw std::runtime_error("Attempting to remove a heap that is not part of the residency set");
+}
+
+void ResidencyManager::MarkUsed(size_t setIndex)
+{
+	ResidencySet& set = sets[setIndex];
+	set.lastUsedFrame = currentFrame;
+
+	if (set.resident == false)
+	{
+		MakeResident(setIndex);
+		LinkAsMostRecentlyUsed(setIndex);
+	}
+	else if (mostRecentlyUsed != setIndex)
+	{
+		Unlink(setIndex);
+		LinkAsMostRecentlyUsed(setIndex);
+	}
+}
+
+void ResidencyManager::SwapFrame()
+{
+	++currentFrame;
+	pageables.clear();
+
+	while (residentSize > budget && leastRecentlyUsed != size_t(-1))
+	{
+		// Sets used by frames that may still be executing on the GPU are not safe to evict
+		if (sets[leastRecentlyUsed].lastUsedFrame + framesInFlight > currentFrame)
+			break;
+
+		Evict(leastRecentlyUsed);
+	}
+
+	SubmitEvict();
+}
+
+void ResidencyManager::SetBudget(size_t budgetInBytes)
+{
+	budget = budgetInBytes;
+}
+
+size_t ResidencyManager::GetBudget() const
+{
+	return budget;
+}
+
+size_t ResidencyManager::GetResidentSize() const
+{
+	return residentSize;
+}
+
+bool ResidencyManager::IsResident(size_t setIndex) const
+{
+	return sets[setIndex].resident;
+}
+
+ResidencyTrackingHeapAllocatorGPU::ResidencyTrackingHeapAllocatorGPU(
+	HeapAllocatorGPU* allocatorToUse, ResidencyManager* residencyManagerToUse,
+	size_t residencySetToUse) : allocator(allocatorToUse),
+	residencyManager(residencyManagerToUse), residencySet(residencySetToUse)
+{
+	// EMPTY
+}
+
+HeapChunk ResidencyTrackingHeapAllocatorGPU::AllocateChunk(
+	size_t minimumRequiredSize, D3D12_HEAP_TYPE requiredType,
+	D3D12_HEAP_FLAGS requiredFlags)
+{
+	HeapChunk toReturn = allocator->AllocateChunk(minimumRequiredSize,
+		requiredType, requiredFlags);
+
+	// Upload and readback heaps are CPU accessible and are never evicted
+	if (toReturn.heapType == D3D12_HEAP_TYPE_DEFAULT)
+	{
+		residencyManager->AddHeap(residencySet, toReturn.heap,
+			static_cast<size_t>(toReturn.heap->GetDesc().SizeInBytes));
+	}
+
+	return toReturn;
+}
+
+void ResidencyTrackingHeapAllocatorGPU::DeallocateChunk(HeapChunk& chunk)
+{
+	if (chunk.heapType == D3D12_HEAP_TYPE_DEFAULT)
+	{
+		residencyManager->RemoveHeap(residencySet, chunk.heap);
+	}
+
+	allocator->DeallocateChunk(chunk);
+}
\ No newline at end of file
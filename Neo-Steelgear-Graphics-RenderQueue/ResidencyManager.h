@@ -0,0 +1,119 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+#include <d3d12.h>
+
+#include <HeapAllocatorGPU.h>
+
+// Receives the residency calls instead of the device, so the eviction policy can be run against a stand-in
+class ResidencyBackend
+{
+public:
+	ResidencyBackend() = default;
+	virtual ~ResidencyBackend() = default;
+	ResidencyBackend(const ResidencyBackend& other) = delete;
+	ResidencyBackend& operator=(const ResidencyBackend& other) = delete;
+	ResidencyBackend(ResidencyBackend&& other) = default;
+	ResidencyBackend& operator=(ResidencyBackend&& other) = default;
+
+	virtual void MakeResident(ID3D12Pageable* const* objects, UINT nrOfObjects) = 0;
+	virtual void Evict(ID3D12Pageable* const* objects, UINT nrOfObjects) = 0;
+};
+
+class ResidencyManager
+{
+private:
+	struct TrackedHeap
+	{
+		ID3D12Heap* heap = nullptr;
+		size_t nrOfChunks = 0;
+	};
+
+	// Heaps may be shared between sets, so a heap is only evicted once no resident set uses it.
+	// The size is that of the whole heap and is counted once, however many chunks and sets use it
+	struct SharedHeap
+	{
+		size_t nrOfSets = 0;
+		size_t nrOfResidentSets = 0;
+		size_t size = 0;
+	};
+
+	struct ResidencySet
+	{
+		std::vector<TrackedHeap> heaps;
+		bool resident = true;
+		std::uint64_t lastUsedFrame = 0;
+		size_t previous = size_t(-1);
+		size_t next = size_t(-1);
+	};
+
+	ID3D12Device* device = nullptr;
+	ResidencyBackend* backend = nullptr;
+	size_t budget = size_t(-1);
+	size_t residentSize = 0;
+	std::uint64_t currentFrame = 0;
+	std::uint8_t framesInFlight = 1;
+
+	// Resident sets form a list from least to most recently used, evicted sets are not part of it
+	std::vector<ResidencySet> sets;
+	std::unordered_map<ID3D12Heap*, SharedHeap> sharedHeaps;
+	size_t leastRecentlyUsed = size_t(-1);
+	size_t mostRecentlyUsed = size_t(-1);
+	std::vector<ID3D12Pageable*> pageables;
+
+	void Unlink(size_t setIndex);
+	void LinkAsMostRecentlyUsed(size_t setIndex);
+	void MakeResident(size_t setIndex);
+	void Evict(size_t setIndex);
+	void SubmitMakeResident();
+	void SubmitEvict();
+
+public:
+	ResidencyManager() = default;
+	~ResidencyManager() = default;
+	ResidencyManager(const ResidencyManager& other) = delete;
+	ResidencyManager& operator=(const ResidencyManager& other) = delete;
+	ResidencyManager(ResidencyManager&& other) = default;
+	ResidencyManager& operator=(ResidencyManager&& other) = default;
+
+	void Initialize(ID3D12Device* deviceToUse, size_t budgetInBytes,
+		std::uint8_t nrOfFramesInFlight, ResidencyBackend* backendToUse = nullptr);
+
+	size_t CreateResidencySet();
+	// Called once per chunk placed in the heap, heapSize is the size of the whole heap
+	void AddHeap(size_t setIndex, ID3D12Heap* heap, size_t heapSize);
+	void RemoveHeap(size_t setIndex, ID3D12Heap* heap);
+
+	void MarkUsed(size_t setIndex);
+	void SwapFrame();
+
+	void SetBudget(size_t budgetInBytes);
+	size_t GetBudget() const;
+	size_t GetResidentSize() const;
+	bool IsResident(size_t setIndex) const;
+};
+
+// Forwards to another allocator and reports the default heaps it hands out to a residency set
+class ResidencyTrackingHeapAllocatorGPU : public HeapAllocatorGPU
+{
+private:
+	HeapAllocatorGPU* allocator = nullptr;
+	ResidencyManager* residencyManager = nullptr;
+	size_t residencySet = size_t(-1);
+
+public:
+	ResidencyTrackingHeapAllocatorGPU(HeapAllocatorGPU* allocatorToUse,
+		ResidencyManager* residencyManagerToUse, size_t residencySetToUse);
+	virtual ~ResidencyTrackingHeapAllocatorGPU() = default;
+	ResidencyTrackingHeapAllocatorGPU(const ResidencyTrackingHeapAllocatorGPU& other) = delete;
+	ResidencyTrackingHeapAllocatorGPU& operator=(const ResidencyTrackingHeapAllocatorGPU& other) = delete;
+	ResidencyTrackingHeapAllocatorGPU(ResidencyTrackingHeapAllocatorGPU&& other) = default;
+	ResidencyTrackingHeapAllocatorGPU& operator=(ResidencyTrackingHeapAllocatorGPU&& other) = default;
+
+	virtual HeapChunk AllocateChunk(size_t minimumRequiredSize,
+		D3D12_HEAP_TYPE requiredType, D3D12_HEAP_FLAGS requiredFlags) override;
+	virtual void DeallocateChunk(HeapChunk& chunk) override;
+};
\ No newline at end of file
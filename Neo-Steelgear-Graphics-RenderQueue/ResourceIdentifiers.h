@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 typedef size_t TransientResourceIndex;
 
 enum class FrameViewType
@@ -17,4 +19,23 @@ struct ViewIdentifier
 	TransientResourceViewIndex internalIndex;
 };
 
-typedef size_t LocalResourceIndex;
\ No newline at end of file
+typedef size_t LocalResourceIndex;
+
+// States are tracked per key mip * 2048 + array slice, so ranges must be
+// non-empty and start within the first 16 mips and 2048 array slices.
+// Ranges extending past those limits are clamped.
+struct SubresourceRange
+{
+	static constexpr std::uint16_t ALL = std::uint16_t(-1);
+
+	std::uint16_t firstMip = 0;
+	std::uint16_t nrOfMips = ALL;
+	std::uint16_t firstArraySlice = 0;
+	std::uint16_t nrOfArraySlices = ALL;
+
+	bool CoversAll() const
+	{
+		return firstMip == 0 && nrOfMips == ALL &&
+			firstArraySlice == 0 && nrOfArraySlices == ALL;
+	}
+};
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include "StreamingCopy.h"
+
+#include <cstring>
+#include <cstdint>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define STREAMING_COPY_X86
+#include <immintrin.h>
+#endif
+
+#if defined(STREAMING_COPY_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#define TARGET_AVX2
+#define TARGET_XSAVE
+#elif defined(STREAMING_COPY_X86)
+#include <cpuid.h>
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_XSAVE __attribute__((target("xsave")))
+#endif
+
+#if defined(STREAMING_COPY_X86)
+namespace
+{
+	constexpr size_t MINIMUM_STREAMING_SIZE = 256;
+
+	void QueryCPUID(unsigned int leaf, unsigned int cpuInfo[4])
+	{
+#if defined(_MSC_VER)
+		__cpuidex(reinterpret_cast<int*>(cpuInfo), static_cast<int>(leaf), 0);
+#else
+		__cpuid_count(leaf, 0, cpuInfo[0], cpuInfo[1], cpuInfo[2], cpuInfo[3]);
+#endif
+	}
+
+	// Matches the target of the wide path, which is compiled for AVX2
+	TARGET_XSAVE bool CheckAVX2Support()
+	{
+		unsigned int cpuInfo[4] = { 0, 0, 0, 0 };
+		QueryCPUID(0, cpuInfo);
+		if (cpuInfo[0] < 7)
+			return false;
+
+		QueryCPUID(1, cpuInfo);
+		const unsigned int osxsaveBit = 1u << 27;
+		const unsigned int avxBit = 1u << 28;
+		if ((cpuInfo[2] & osxsaveBit) == 0 || (cpuInfo[2] & avxBit) == 0)
+			return false;
+
+		// The OS must also save the upper halves of the ymm registers
+		unsigned long long enabledStates = _xgetbv(0);
+		if ((enabledStates & 0x6) != 0x6)
+			return false;
+
+		QueryCPUID(7, cpuInfo);
+		const unsigned int avx2Bit = 1u << 5;
+		return (cpuInfo[1] & avx2Bit) != 0;
+	}
+
+	const bool AVX2_SUPPORTED = CheckAVX2Support();
+
+	size_t AlignDestination(unsigned char*& destination,
+		const unsigned char*& source, size_t size, size_t alignment)
+	{
+		size_t misalignment = reinterpret_cast<std::uintptr_t>(destination) & (alignment - 1);
+		size_t headSize = misalignment == 0 ? 0 : alignment - misalignment;
+		std::memcpy(destination, source, headSize);
+		destination += headSize;
+		source += headSize;
+
+		return size - headSize;
+	}
+
+	TARGET_AVX2 size_t StreamAVX2(unsigned char* destination,
+		const unsigned char* source, size_t size)
+	{
+		size_t copied = 0;
+
+		for (; copied + 128 <= size; copied += 128)
+		{
+			__m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + copied));
+			__m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + copied + 32));
+			__m256i third = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + copied + 64));
+			__m256i fourth = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + copied + 96));
+			_mm256_stream_si256(reinterpret_cast<__m256i*>(destination + copied), first);
+			_mm256_stream_si256(reinterpret_cast<__m256i*>(destination + copied + 32), second);
+			_mm256_stream_si256(reinterpret_cast<__m256i*>(destination + copied + 64), third);
+			_mm256_stream_si256(reinterpret_cast<__m256i*>(destination + copied + 96), fourth);
+		}
+
+		for (; copied + 32 <= size; copied += 32)
+		{
+			__m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + copied));
+			_mm256_stream_si256(reinterpret_cast<__m256i*>(destination + copied), data);
+		}
+
+		_mm256_zeroupper();
+		return copied;
+	}
+
+	size_t StreamSSE2(unsigned char* destination, const unsigned char* source, size_t size)
+	{
+		size_t copied = 0;
+
+		for (; copied + 64 <= size; copied += 64)
+		{
+			__m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + copied));
+			__m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + copied + 16));
+			__m128i third = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + copied + 32));
+			__m128i fourth = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + copied + 48));
+			_mm_stream_si128(reinterpret_cast<__m128i*>(destination + copied), first);
+			_mm_stream_si128(reinterpret_cast<__m128i*>(destination + copied + 16), second);
+			_mm_stream_si128(reinterpret_cast<__m128i*>(destination + copied + 32), third);
+			_mm_stream_si128(reinterpret_cast<__m128i*>(destination + copied + 48), fourth);
+		}
+
+		for (; copied + 16 <= size; copied += 16)
+		{
+			__m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + copied));
+			_mm_stream_si128(reinterpret_cast<__m128i*>(destination + copied), data);
+		}
+
+		return copied;
+	}
+}
+#endif
+
+void StreamingCopy(void* destination, const void* source, size_t size)
+{
+#if !defined(STREAMING_COPY_X86)
+	std::memcpy(destination, source, size);
+#else
+	if (size < MINIMUM_STREAMING_SIZE)
+	{
+		std::memcpy(destination, source, size);
+		return;
+	}
+
+	unsigned char* destinationBytes = static_cast<unsigned char*>(destination);
+	const unsigned char* sourceBytes = static_cast<const unsigned char*>(source);
+	size_t alignment = AVX2_SUPPORTED ? 32 : 16;
+	size_t sizeLeft = AlignDestination(destinationBytes, sourceBytes, size, alignment);
+
+	size_t streamed = AVX2_SUPPORTED ? StreamAVX2(destinationBytes, sourceBytes, sizeLeft) :
+		StreamSSE2(destinationBytes, sourceBytes, sizeLeft);
+	std::memcpy(destinationBytes + streamed, sourceBytes + streamed, sizeLeft - streamed);
+
+	// Make the streamed writes visible before the GPU can be told to read them
+	_mm_sfence();
+#endif
+}
\ No newline at end of file
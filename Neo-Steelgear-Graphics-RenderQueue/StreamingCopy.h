@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstddef>
+
+// Copies to memory that is only written by the CPU, such as write-combined
+// upload heaps. Large copies use non-temporal stores that bypass the cache.
+void StreamingCopy(void* destination, const void* source, size_t size);
\ No newline at end of file
@@ -0,0 +1,21 @@
+#include "SynchronizedHeapAllocatorGPU.h"
+
+SynchronizedHeapAllocatorGPU::SynchronizedHeapAllocatorGPU(
+	HeapAllocatorGPU* allocatorToUse, std::mutex* mutexToUse) :
+	allocator(allocatorToUse), mutex(mutexToUse)
+{
+	// EMPTY
+}
+
+HeapChunk SynchronizedHeapAllocatorGPU::AllocateChunk(size_t minimumRequiredSize,
+	D3D12_HEAP_TYPE requiredType, D3D12_HEAP_FLAGS requiredFlags)
+{
+	std::lock_guard<std::mutex> lock(*mutex);
+	return allocator->AllocateChunk(minimumRequiredSize, requiredType, requiredFlags);
+}
+
+void SynchronizedHeapAllocatorGPU::DeallocateChunk(HeapChunk& chunk)
+{
+	std::lock_guard<std::mutex> lock(*mutex);
+	allocator->DeallocateChunk(chunk);
+}
\ No newline at end of file
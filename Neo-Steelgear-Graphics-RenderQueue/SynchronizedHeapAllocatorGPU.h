@@ -0,0 +1,25 @@
+#pragma once
+
+#include <mutex>
+
+#include <HeapAllocatorGPU.h>
+
+// Serializes chunk requests to another allocator, allocators sharing a mutex are serialized with each other
+class SynchronizedHeapAllocatorGPU : public HeapAllocatorGPU
+{
+private:
+	HeapAllocatorGPU* allocator = nullptr;
+	std::mutex* mutex = nullptr;
+
+public:
+	SynchronizedHeapAllocatorGPU(HeapAllocatorGPU* allocatorToUse, std::mutex* mutexToUse);
+	virtual ~SynchronizedHeapAllocatorGPU() = default;
+	SynchronizedHeapAllocatorGPU(const SynchronizedHeapAllocatorGPU& other) = delete;
+	SynchronizedHeapAllocatorGPU& operator=(const SynchronizedHeapAllocatorGPU& other) = delete;
+	SynchronizedHeapAllocatorGPU(SynchronizedHeapAllocatorGPU&& other) = default;
+	SynchronizedHeapAllocatorGPU& operator=(SynchronizedHeapAllocatorGPU&& other) = default;
+
+	virtual HeapChunk AllocateChunk(size_t minimumRequiredSize,
+		D3D12_HEAP_TYPE requiredType, D3D12_HEAP_FLAGS requiredFlags) override;
+	virtual void DeallocateChunk(HeapChunk& chunk) override;
+};
\ No newline at end of file
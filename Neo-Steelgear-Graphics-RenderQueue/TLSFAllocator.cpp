@@ -0,0 +1,276 @@
+#include "TLSFAllocator.h"
+
+#include <bit>
+#include <stdexcept>
+
+void TLSFAllocator::GetSizeClass(size_t sizeInUnits, size_t& firstLevel,
+	size_t& secondLevel)
+{
+	// Sizes below one full set of subdivisions get a class each
+	if (sizeInUnits < NR_OF_SECOND_LEVELS)
+	{
+		firstLevel = 0;
+		secondLevel = sizeInUnits;
+		return;
+	}
+
+	size_t highestBit = std::bit_width(sizeInUnits) - 1;
+	firstLevel = highestBit - SECOND_LEVEL_LOG2 + 1;
+	secondLevel = (sizeInUnits >> (highestBit - SECOND_LEVEL_LOG2)) - NR_OF_SECOND_LEVELS;
+}
+
+size_t TLSFAllocator::CreateBlock(size_t offset, size_t size)
+{
+	size_t toReturn = blocks.size();
+
+	if (unusedBlocks.size() != 0)
+	{
+		toReturn = unusedBlocks.back();
+		unusedBlocks.pop_back();
+		blocks[toReturn] = Block();
+	}
+	else
+	{
+		blocks.push_back(Block());
+	}
+
+	blocks[toReturn].offset = offset;
+	blocks[toReturn].size = size;
+	return toReturn;
+}
+
+void TLSFAllocator::DestroyBlock(size_t blockIndex)
+{
+	unusedBlocks.push_back(blockIndex);
+}
+
+void TLSFAllocator::InsertFreeBlock(size_t blockIndex)
+{
+	size_t firstLevel = 0;
+	size_t secondLevel = 0;
+	GetSizeClass(blocks[blockIndex].size / granularity, firstLevel, secondLevel);
+
+	Block& block = blocks[blockIndex];
+	size_t& head = freeLists[firstLevel][secondLevel];
+	block.free = true;
+	block.previousFree = size_t(-1);
+	block.nextFree = head;
+
+	if (head != size_t(-1))
+		blocks[head].previousFree = blockIndex;
+
+	head = blockIndex;
+	firstLevelBitmap |= std::uint64_t(1) << firstLevel;
+	secondLevelBitmaps[firstLevel] |= std::uint32_t(1) << secondLevel;
+}
+
+void TLSFAllocator::RemoveFreeBlock(size_t blockIndex)
+{
+	size_t firstLevel = 0;
+	size_t secondLevel = 0;
+	GetSizeClass(blocks[blockIndex].size / granularity, firstLevel, secondLevel);
+
+	Block& block = blocks[blockIndex];
+	block.free = false;
+
+	if (block.previousFree != size_t(-1))
+		blocks[block.previousFree].nextFree = block.nextFree;
+	else
+		freeLists[firstLevel][secondLevel] = block.nextFree;
+
+	if (block.nextFree != size_t(-1))
+		blocks[block.nextFree].previousFree = block.previousFree;
+
+	if (freeLists[firstLevel][secondLevel] == size_t(-1))
+	{
+		secondLevelBitmaps[firstLevel] &= ~(std::uint32_t(1) << secondLevel);
+
+		if (secondLevelBitmaps[firstLevel] == 0)
+			firstLevelBitmap &= ~(std::uint64_t(1) << firstLevel);
+	}
+}
+
+size_t TLSFAllocator::FindFreeBlock(size_t size) const
+{
+	// Rounding up one class means that any block found through the bitmaps is large enough
+	size_t sizeInUnits = size / granularity;
+	if (sizeInUnits >= NR_OF_SECOND_LEVELS)
+	{
+		size_t highestBit = std::bit_width(sizeInUnits) - 1;
+		sizeInUnits += (size_t(1) << (highestBit - SECOND_LEVEL_LOG2)) - 1;
+	}
+
+	size_t firstLevel = 0;
+	size_t secondLevel = 0;
+	GetSizeClass(sizeInUnits, firstLevel, secondLevel);
+
+	if (firstLevel >= NR_OF_FIRST_LEVELS)
+		return FindInSizeClass(size);
+
+	std::uint32_t secondLevelCandidates =
+		secondLevelBitmaps[firstLevel] & (~std::uint32_t(0) << secondLevel);
+
+	if (secondLevelCandidates == 0)
+	{
+		std::uint64_t firstLevelCandidates = firstLevel + 1 < 64 ?
+			firstLevelBitmap & (~std::uint64_t(0) << (firstLevel + 1)) : 0;
+
+		if (firstLevelCandidates == 0)
+			return FindInSizeClass(size);
+
+		firstLevel = std::countr_zero(firstLevelCandidates);
+		secondLevelCandidates = secondLevelBitmaps[firstLevel];
+	}
+
+	return freeLists[firstLevel][std::countr_zero(secondLevelCandidates)];
+}
+
+size_t TLSFAllocator::FindInSizeClass(size_t size) const
+{
+	// Blocks in the same class as the request may still fit it, such as a whole empty heap
+	size_t firstLevel = 0;
+	size_t secondLevel = 0;
+	GetSizeClass(size / granularity, firstLevel, secondLevel);
+
+	if (firstLevel >= NR_OF_FIRST_LEVELS)
+		return size_t(-1);
+
+	for (size_t blockIndex = freeLists[firstLevel][secondLevel];
+		blockIndex != size_t(-1); blockIndex = blocks[blockIndex].nextFree)
+	{
+		if (blocks[blockIndex].size >= size)
+			return blockIndex;
+	}
+
+	return size_t(-1);
+}
+
+void TLSFAllocator::MergeWithNext(size_t blockIndex)
+{
+	size_t nextIndex = blocks[blockIndex].nextPhysical;
+	size_t afterNext = blocks[nextIndex].nextPhysical;
+	blocks[blockIndex].size += blocks[nextIndex].size;
+	blocks[blockIndex].nextPhysical = afterNext;
+
+	if (afterNext != size_t(-1))
+		blocks[afterNext].previousPhysical = blockIndex;
+
+	DestroyBlock(nextIndex);
+}
+
+TLSFAllocator::TLSFAllocator()
+{
+	for (auto& secondLevels : freeLists)
+	{
+		for (size_t& head : secondLevels)
+			head = size_t(-1);
+	}
+}
+
+size_t TLSFAllocator::GetAllocationSize(size_t size, size_t granularity)
+{
+	size_t nrOfUnits = size == 0 ? 1 : (size + granularity - 1) / granularity;
+	return nrOfUnits * granularity;
+}
+
+void TLSFAllocator::Initialize(size_t size, size_t granularityToUse)
+{
+	if (granularityToUse == 0)
+		throw std::runtime_error("TLSF allocator granularity must be larger than zero");
+
+	*this = TLSFAllocator();
+	granularity = granularityToUse;
+	totalSize = size - size % granularity;
+
+	if (totalSize != 0)
+		InsertFreeBlock(CreateBlock(0, totalSize));
+}
+
+size_t TLSFAllocator::Allocate(size_t size)
+{
+	size_t allocationSize = GetAllocationSize(size, granularity);
+	if (allocationSize > totalSize)
+		return size_t(-1);
+
+	size_t blockIndex = FindFreeBlock(allocationSize);
+	if (blockIndex == size_t(-1))
+		return size_t(-1);
+
+	RemoveFreeBlock(blockIndex);
+
+	if (blocks[blockIndex].size > allocationSize)
+	{
+		size_t remainderIndex = CreateBlock(blocks[blockIndex].offset + allocationSize,
+			blocks[blockIndex].size - allocationSize);
+		size_t nextIndex = blocks[blockIndex].nextPhysical;
+		blocks[remainderIndex].previousPhysical = blockIndex;
+		blocks[remainderIndex].nextPhysical = nextIndex;
+
+		if (nextIndex != size_t(-1))
+			blocks[nextIndex].previousPhysical = remainderIndex;
+
+		blocks[blockIndex].nextPhysical = remainderIndex;
+		blocks[blockIndex].size = allocationSize;
+		InsertFreeBlock(remainderIndex);
+	}
+
+	allocatedBlocks[blocks[blockIndex].offset] = blockIndex;
+	allocatedSize += allocationSize;
+	return blocks[blockIndex].offset;
+}
+
+void TLSFAllocator::Deallocate(size_t offset)
+{
+	auto allocatedBlock = allocatedBlocks.find(offset);
+	if (allocatedBlock == allocatedBlocks.end())
+		throw std::runtime_error("Attempting to deallocate an offset that is not allocated from the TLSF allocator");
+
+	size_t blockIndex = allocatedBlock->second;
+	allocatedBlocks.erase(allocatedBlock);
+	allocatedSize -= blocks[blockIndex].size;
+
+	size_t nextIndex = blocks[blockIndex].nextPhysical;
+	if (nextIndex != size_t(-1) && blocks[nextIndex].free)
+	{
+		RemoveFreeBlock(nextIndex);
+		MergeWithNext(blockIndex);
+	}
+
+	size_t previousIndex = blocks[blockIndex].previousPhysical;
+	if (previousIndex != size_t(-1) && blocks[previousIndex].free)
+	{
+		RemoveFreeBlock(previousIndex);
+		MergeWithNext(previousIndex);
+		blockIndex = previousIndex;
+	}
+
+	InsertFreeBlock(blockIndex);
+}
+
+size_t TLSFAllocator::GetTotalSize() const
+{
+	return totalSize;
+}
+
+size_t TLSFAllocator::GetAllocatedSize() const
+{
+	return allocatedSize;
+}
+
+size_t TLSFAllocator::GetLargestFreeSize() const
+{
+	if (firstLevelBitmap == 0)
+		return 0;
+
+	size_t firstLevel = std::bit_width(firstLevelBitmap) - 1;
+	size_t secondLevel = std::bit_width(secondLevelBitmaps[firstLevel]) - 1;
+	size_t toReturn = 0;
+
+	for (size_t blockIndex = freeLists[firstLevel][secondLevel];
+		blockIndex != size_t(-1); blockIndex = blocks[blockIndex].nextFree)
+	{
+		toReturn = blocks[blockIndex].size > toReturn ? blocks[blockIndex].size : toReturn;
+	}
+
+	return toReturn;
+}
\ No newline at end of file
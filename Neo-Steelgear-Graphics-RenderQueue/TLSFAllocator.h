@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+// Two-level segregated fit allocator over a range of offsets, every allocation is a multiple of the granularity
+class TLSFAllocator
+{
+private:
+	static constexpr size_t SECOND_LEVEL_LOG2 = 4;
+	static constexpr size_t NR_OF_SECOND_LEVELS = size_t(1) << SECOND_LEVEL_LOG2;
+	static constexpr size_t NR_OF_FIRST_LEVELS = sizeof(size_t) * 8 - SECOND_LEVEL_LOG2 + 1;
+
+	// Blocks are linked to their neighbours in address order, which lets a freed block merge in constant time
+	struct Block
+	{
+		size_t offset = 0;
+		size_t size = 0;
+		size_t previousPhysical = size_t(-1);
+		size_t nextPhysical = size_t(-1);
+		size_t previousFree = size_t(-1);
+		size_t nextFree = size_t(-1);
+		bool free = false;
+	};
+
+	size_t granularity = 1;
+	size_t totalSize = 0;
+	size_t allocatedSize = 0;
+	std::vector<Block> blocks;
+	std::vector<size_t> unusedBlocks;
+	std::unordered_map<size_t, size_t> allocatedBlocks;
+
+	std::uint64_t firstLevelBitmap = 0;
+	std::uint32_t secondLevelBitmaps[NR_OF_FIRST_LEVELS] = {};
+	size_t freeLists[NR_OF_FIRST_LEVELS][NR_OF_SECOND_LEVELS];
+
+	static void GetSizeClass(size_t sizeInUnits, size_t& firstLevel, size_t& secondLevel);
+
+	size_t CreateBlock(size_t offset, size_t size);
+	void DestroyBlock(size_t blockIndex);
+	void InsertFreeBlock(size_t blockIndex);
+	void RemoveFreeBlock(size_t blockIndex);
+	size_t FindFreeBlock(size_t size) const;
+	size_t FindInSizeClass(size_t size) const;
+	void MergeWithNext(size_t blockIndex);
+
+public:
+	TLSFAllocator();
+	~TLSFAllocator() = default;
+	TLSFAllocator(const TLSFAllocator& other) = default;
+	TLSFAllocator& operator=(const TLSFAllocator& other) = default;
+	TLSFAllocator(TLSFAllocator&& other) = default;
+	TLSFAllocator& operator=(TLSFAllocator&& other) = default;
+
+	static size_t GetAllocationSize(size_t size, size_t granularity);
+
+	void Initialize(size_t size, size_t granularityToUse);
+
+	// Returns size_t(-1) if no free range is large enough
+	size_t Allocate(size_t size);
+	void Deallocate(size_t offset);
+
+	size_t GetTotalSize() const;
+	size_t GetAllocatedSize() const;
+	size_t GetLargestFreeSize() const;
+};
\ No newline at end of file
@@ -5,7 +5,7 @@
 #include <HeapHelper.h>
 #include <HeapAllocatorGPU.h>
 #include <D3DPtr.h>
-#include <DescriptorAllocator.h>
+#include "BitmapDescriptorAllocator.h"
 
 #include "TransientResourceDesc.h"
 #include "ResourceIdentifiers.h"
@@ -54,9 +54,9 @@ private:
 	std::vector<MemoryChunk> memoryChunks;
 	std::vector<TransientResourceIdentifier> identifiers;
 
-	DescriptorAllocator shaderBindableDescriptors;
-	DescriptorAllocator rtvDescriptors;
-	DescriptorAllocator dsvDescriptors;
+	BitmapDescriptorAllocator shaderBindableDescriptors;
+	BitmapDescriptorAllocator rtvDescriptors;
+	BitmapDescriptorAllocator dsvDescriptors;
 
 	ID3D12Resource* AllocateResource(const TransientResourceDesc& desc, 
 		ID3D12Heap* heap, size_t heapOffset, D3D12_RESOURCE_STATES initialState);
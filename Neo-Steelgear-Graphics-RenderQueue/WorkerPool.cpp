@@ -0,0 +1,118 @@
+#include "WorkerPool.h"
+
+#include <stdexcept>
+
+void WorkerPool::WorkerLoop(size_t workerIndex)
+{
+	std::uint64_t handledGeneration = 0;
+
+	while (true)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		workAvailable.wait(lock, [&]()
+		{
+			return stopping || generation != handledGeneration;
+		});
+
+		if (stopping)
+			return;
+
+		handledGeneration = generation;
+		size_t taskIndex = workerIndex + 1;
+		if (taskIndex >= nrOfTasks)
+			continue;
+
+		const std::function<void(size_t)>& toRun = *task;
+		lock.unlock();
+
+		std::exception_ptr thrown = nullptr;
+		try
+		{
+			toRun(taskIndex);
+		}
+		catch (...)
+		{
+			thrown = std::current_exception();
+		}
+
+		lock.lock();
+		if (thrown != nullptr && exception == nullptr)
+			exception = thrown;
+
+		if (--tasksRunning == 0)
+			workFinished.notify_one();
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+
+	workAvailable.notify_all();
+	for (auto& worker : workers)
+		worker.join();
+}
+
+void WorkerPool::Initialize(size_t nrOfWorkers)
+{
+	if (!workers.empty())
+		throw std::runtime_error("Worker pool is already initialized");
+
+	workers.reserve(nrOfWorkers);
+	for (size_t i = 0; i < nrOfWorkers; ++i)
+		workers.emplace_back(&WorkerPool::WorkerLoop, this, i);
+}
+
+void WorkerPool::Run(size_t nrOfTasksToRun, const std::function<void(size_t)>& taskToRun)
+{
+	if (nrOfTasksToRun == 0)
+		return;
+
+	if (nrOfTasksToRun > workers.size() + 1)
+		throw std::runtime_error("Worker pool cannot run more tasks than it has workers");
+
+	if (nrOfTasksToRun > 1)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		task = &taskToRun;
+		nrOfTasks = nrOfTasksToRun;
+		tasksRunning = nrOfTasksToRun - 1;
+		exception = nullptr;
+		++generation;
+		workAvailable.notify_all();
+	}
+
+	std::exception_ptr thrown = nullptr;
+	try
+	{
+		taskToRun(0);
+	}
+	catch (...)
+	{
+		thrown = std::current_exception();
+	}
+
+	if (nrOfTasksToRun > 1)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		workFinished.wait(lock, [&]()
+		{
+			return tasksRunning == 0;
+		});
+
+		task = nullptr;
+		if (thrown == nullptr)
+			thrown = exception;
+	}
+
+	if (thrown != nullptr)
+		std::rethrow_exception(thrown);
+}
+
+size_t WorkerPool::GetNrOfWorkers() const
+{
+	return workers.size();
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <cstdint>
+
+// Threads that are created once and reused, instead of being started and joined every frame
+class WorkerPool
+{
+private:
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable workAvailable;
+	std::condition_variable workFinished;
+
+	const std::function<void(size_t)>* task = nullptr;
+	std::uint64_t generation = 0;
+	size_t nrOfTasks = 0;
+	size_t tasksRunning = 0;
+	std::exception_ptr exception = nullptr;
+	bool stopping = false;
+
+	void WorkerLoop(size_t workerIndex);
+
+public:
+	WorkerPool() = default;
+	~WorkerPool();
+	WorkerPool(const WorkerPool& other) = delete;
+	WorkerPool& operator=(const WorkerPool& other) = delete;
+	WorkerPool(WorkerPool&& other) = delete;
+	WorkerPool& operator=(WorkerPool&& other) = delete;
+
+	void Initialize(size_t nrOfWorkers);
+
+	// Task i runs on worker i - 1 and task 0 on the calling thread, returns once all tasks are done
+	void Run(size_t nrOfTasksToRun, const std::function<void(size_t)>& taskToRun);
+	size_t GetNrOfWorkers() const;
+};
\ No newline at end of file